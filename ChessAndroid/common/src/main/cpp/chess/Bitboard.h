@@ -368,6 +368,14 @@ public:
 		return fromBetween(sq1, sq2) | fromSquare(sq1) | fromSquare(sq2);
 	}
 
+	/**
+	 * The whole rank, file or diagonal that goes through both squares, from one edge of the board to the other
+	 */
+	static force_inline constexpr Bitboard fromFullLine(const Square sq1, const Square sq2) noexcept
+	{
+		return SquaresLine[u8(sq1)][u8(sq2)];
+	}
+
 	static force_inline constexpr Bitboard fromRank(const Square square) noexcept
 	{
 		constexpr auto Ranks = []
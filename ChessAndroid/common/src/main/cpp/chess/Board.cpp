@@ -88,6 +88,10 @@ void Board::makeMove(const Move move, const bool moveGivesCheck) noexcept
 	auto &castlingRights = state.castlingRights;
 	auto &enPassantSq = state.enPassantSq;
 
+	// Both are removed from the key before they are updated, then added back
+	Zobrist::xorEnPassant(state.zKey, enPassantSq);
+	Zobrist::xorCastlingRights(state.zKey, CastlingRights(castlingRights));
+
 	if (flags.enPassant())
 	{
 		assert(to == enPassantSq);
@@ -108,17 +112,14 @@ void Board::makeMove(const Move move, const bool moveGivesCheck) noexcept
 		castlingRights |= (side ? CASTLED_WHITE : CASTLED_BLACK);
 	}
 
-	Zobrist::xorEnPassant(state.zKey, enPassantSq);
-	Zobrist::xorCastlingRights(state.zKey, CastlingRights(castlingRights));
-
 	if (canCastle(side))
 	{
+		// Only the rooks on their starting squares matter, another one may have been promoted on the same file
 		if (movedPiece == ROOK)
 		{
-			const auto rookFile = Bitboard::fromFile(from);
-			if (rookFile == FILE_A)
+			if (from == shiftToKingRank(side, SQ_A1))
 				castlingRights &= ~(side ? CASTLE_WHITE_QUEEN : CASTLE_BLACK_QUEEN);
-			else if (rookFile == FILE_H)
+			else if (from == shiftToKingRank(side, SQ_H1))
 				castlingRights &= ~(side ? CASTLE_WHITE_KING : CASTLE_BLACK_KING);
 		} else if (movedPiece == KING)
 			// Remove all castling rights if the king is moved
@@ -134,16 +135,17 @@ void Board::makeMove(const Move move, const bool moveGivesCheck) noexcept
 		assert(Piece::isValid(capturedType));
 		if (capturedType == ROOK && canCastle(~side))
 		{
-			const auto rookFile = Bitboard::fromFile(to);
-			if (rookFile == FILE_A)
+			if (to == shiftToKingRank(~side, SQ_A1))
 				castlingRights &= ~(~side ? CASTLE_WHITE_QUEEN : CASTLE_BLACK_QUEEN);
-			else if (rookFile == FILE_H)
+			else if (to == shiftToKingRank(~side, SQ_H1))
 				castlingRights &= ~(~side ? CASTLE_WHITE_KING : CASTLE_BLACK_KING);
 		}
 		removePiece(to);
 		state.fiftyMoveRule = 0;
 	}
 
+	Zobrist::xorCastlingRights(state.zKey, CastlingRights(castlingRights));
+
 	++historyPly;
 	++ply;
 
@@ -365,6 +367,188 @@ bool Board::isMoveLegal(const Move move) const noexcept
 		   || Bitboard::areAligned(from, kingSq, to);
 }
 
+/**
+ * Rebuilds the full move from its squares and promoted piece, as stored in the Transposition Table.
+ * Returns an empty move if the move could not have been generated in this position.
+ * The legality of the move still has to be checked with isMoveLegal()
+ */
+Move Board::getPseudoLegalMove(const Square from, const Square to, const PieceType promotedPiece) const noexcept
+{
+	const Color us = colorToMove;
+	const Piece piece = getSquare(from);
+	const auto toBb = Bitboard::fromSquare(to);
+
+	if (from == to || !piece.isValid() || piece.color() != us || (getPieces(us) & toBb).notEmpty())
+		return {};
+
+	const PieceType movedPiece = piece.type();
+	const PieceType capturedPiece = getSquare(to).type();
+	const auto kingAttackers = getKingAttackers();
+
+	Move move{ from, to, movedPiece };
+	u8 flags{};
+	if (capturedPiece != NO_PIECE_TYPE)
+	{
+		flags |= Move::Flags::CAPTURE;
+		move.setCapturedPiece(capturedPiece);
+	}
+
+	if (movedPiece == PAWN)
+	{
+		const auto fromBb = Bitboard::fromSquare(from);
+		const Square pushSq = us == WHITE ? shift<NORTH>(from) : shift<SOUTH>(from);
+		const bool attacks = (Attacks::pawnAttacks(us, fromBb) & toBb).notEmpty();
+
+		if (capturedPiece != NO_PIECE_TYPE)
+		{
+			if (!attacks)
+				return {};
+		} else if (to == getEnPassantSq() && attacks)
+		{
+			// Only the pawn that gave check can be captured en passant when in check
+			if (kingAttackers.notEmpty()
+				&& kingAttackers != Bitboard::fromSquare(capturedEnPassantSq(us, to)))
+				return {};
+			flags = Move::Flags::EN_PASSANT;
+		} else if (to != pushSq)
+		{
+			const auto startRank = us == WHITE ? RANK_2 : RANK_7;
+			const Square doublePushSq = us == WHITE ? shift<NORTH>(pushSq) : shift<SOUTH>(pushSq);
+
+			if ((fromBb & startRank).empty() || to != doublePushSq || getSquare(pushSq).isValid())
+				return {};
+			flags |= Move::Flags::DOUBLE_PAWN_PUSH;
+		}
+
+		if ((toBb & (RANK_1 | RANK_8)).notEmpty())
+		{
+			if (promotedPiece < KNIGHT || promotedPiece > QUEEN)
+				return {};
+			flags |= Move::Flags::PROMOTION;
+			move.setPromotedPiece(promotedPiece);
+		}
+	} else if (movedPiece == KING && (Attacks::kingAttacks(from) & toBb).empty())
+	{
+		if (kingAttackers.notEmpty() || rankOf(from) != rankOf(to))
+			return {};
+
+		const bool kingSide = to > from;
+		const CastlingRights side = us == WHITE
+									? (kingSide ? CASTLE_WHITE_KING : CASTLE_WHITE_QUEEN)
+									: (kingSide ? CASTLE_BLACK_KING : CASTLE_BLACK_QUEEN);
+		const Square kingTo = shiftToKingRank(us, kingSide ? SQ_G1 : SQ_C1);
+		const Square rookFrom = shiftToKingRank(us, kingSide ? SQ_H1 : SQ_A1);
+		const Square rookTo = shiftToKingRank(us, kingSide ? SQ_F1 : SQ_D1);
+
+		if (!(state.castlingRights & side) || from != shiftToKingRank(us, SQ_E1) || to != kingTo)
+			return {};
+
+		auto mask = Bitboard::fromBetween(from, kingTo) | Bitboard::fromSquare(kingTo);
+		mask |= Bitboard::fromBetween(rookFrom, rookTo) | Bitboard::fromSquare(rookTo);
+		mask &= ~(Bitboard::fromSquare(from) | Bitboard::fromSquare(rookFrom));
+
+		// There can't be any pieces in between the rook and king
+		if ((getPieces() & mask).notEmpty())
+			return {};
+
+		// The King can't pass through a checked square
+		mask = Bitboard::fromBetween(from, kingTo);
+		while (mask.notEmpty())
+			if (generateAttackers(~us, mask.popLsb(), getPieces()).notEmpty())
+				return {};
+
+		flags = kingSide ? Move::Flags::KSIDE_CASTLE : Move::Flags::QSIDE_CASTLE;
+	} else if (movedPiece != KING && (Attacks::pieceAttacks(movedPiece, from, getPieces()) & toBb).empty())
+		return {};
+
+	if (promotedPiece != NO_PIECE_TYPE && !(flags & Move::Flags::PROMOTION))
+		return {};
+
+	// When in check, the other pieces can only capture the attacker or block it
+	if (movedPiece != KING && kingAttackers.notEmpty() && !(flags & Move::Flags::EN_PASSANT))
+	{
+		if (kingAttackers.several()
+			|| ((Bitboard::fromBetween(getKingSq(us), kingAttackers.bitScanForward()) | kingAttackers) & toBb).empty())
+			return {};
+	}
+
+	move.setFlags(flags);
+	return move;
+}
+
+/**
+ * Static Exchange Evaluation: plays out all the captures on the target square of the move,
+ * always with the least valuable attacker, and checks if the side to move gains at least threshold
+ */
+bool Board::see(const Move move, const int threshold) const noexcept
+{
+	const auto flags = move.flags();
+
+	// Castling, en passant and promotions are not handled
+	if (flags.kSideCastle() || flags.qSideCastle() || flags.enPassant() || flags.promotion())
+		return threshold <= 0;
+
+	const Square from = move.from();
+	const Square to = move.to();
+
+	int swap = Evaluation::getPieceValue(getSquare(to).type()) - threshold;
+	if (swap < 0)
+		return false;
+
+	swap = Evaluation::getPieceValue(getSquare(from).type()) - swap;
+	if (swap <= 0)
+		return true;
+
+	Bitboard occupied = getPieces() ^ Bitboard::fromSquare(from) ^ Bitboard::fromSquare(to);
+	Bitboard attackers = generateAttackers(to, occupied);
+	const auto bishops = getPieces(BISHOP, QUEEN);
+	const auto rooks = getPieces(ROOK, QUEEN);
+
+	Color side = colorToMove;
+	bool result = true;
+
+	while (true)
+	{
+		side = ~side;
+		attackers &= occupied;
+
+		Bitboard sideAttackers = attackers & getPieces(side);
+		if (sideAttackers.empty())
+			break;
+
+		// Pinned pieces can't capture as long as their pinners are still on the board
+		if ((state.kingPinners[~side] & occupied).notEmpty())
+			sideAttackers &= ~getKingBlockers(side);
+
+		if (sideAttackers.empty())
+			break;
+
+		result = !result;
+
+		// Capture with the least valuable attacker, then add the sliders that were behind it
+		PieceType attacker = PAWN;
+		while ((sideAttackers & getPieces(attacker)).empty())
+			attacker = PieceType(attacker + 1);
+
+		if (attacker == KING)
+			// The King can only capture if the other side has no attackers left
+			return (attackers & getPieces(~side)).notEmpty() ? !result : result;
+
+		swap = Evaluation::getPieceValue(attacker) - swap;
+		if (swap < int(result))
+			break;
+
+		occupied ^= Bitboard::fromSquare((sideAttackers & getPieces(attacker)).bitScanForward());
+
+		if (attacker == PAWN || attacker == BISHOP || attacker == QUEEN)
+			attackers |= Attacks::bishopAttacks(to, occupied) & bishops;
+		if (attacker == ROOK || attacker == QUEEN)
+			attackers |= Attacks::rookAttacks(to, occupied) & rooks;
+	}
+
+	return result;
+}
+
 Bitboard Board::generateAttackers(Color attackerColor, Square sq, Bitboard blockers) const noexcept
 {
 	return generateAttackers(sq, blockers) & getPieces(attackerColor);
@@ -80,6 +80,8 @@ public:
 	void undoNullMove() noexcept;
 	[[nodiscard]] bool doesMoveGiveCheck(Move move) const noexcept;
 	[[nodiscard]] bool isMoveLegal(Move move) const noexcept;
+	[[nodiscard]] Move getPseudoLegalMove(Square from, Square to, PieceType promotedPiece) const noexcept;
+	[[nodiscard]] bool see(Move move, int threshold = 0) const noexcept;
 
 	// endregion
 
@@ -99,6 +101,7 @@ public:
 	void computeCheckInfo() noexcept;
 	[[nodiscard]] Bitboard getKingAttackers() const noexcept;
 	[[nodiscard]] Bitboard getKingBlockers(Color color) const noexcept;
+	[[nodiscard]] Bitboard getCheckSquares(PieceType type) const noexcept;
 
 	[[nodiscard]] std::string toString() const noexcept;
 
@@ -216,3 +219,8 @@ force_inline Bitboard Board::getKingBlockers(const Color color) const noexcept
 {
 	return state.kingBlockers[color];
 }
+
+force_inline Bitboard Board::getCheckSquares(const PieceType type) const noexcept
+{
+	return state.possibleCheckSquares[type];
+}
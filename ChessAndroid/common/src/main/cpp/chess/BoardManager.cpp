@@ -48,7 +48,7 @@ bool BoardManager::loadGame(const bool isPlayerWhite, const std::string &fen, co
 
 	for (const Move &move : moves)
 	{
-		if (move.empty() || !moveExists(_currentBoard, move) || !_currentBoard.isMoveLegal(move))
+		if (move.empty() || !moveExists(_currentBoard, move))
 			break;
 		_currentBoard.makeMove(move);
 		_movesStack.push(_currentBoard, move);
@@ -152,7 +152,7 @@ std::vector<Move> BoardManager::getPossibleMoves(const Square from)
 	moves.reserve(allMoves.size());
 
 	for (const Move &move : allMoves)
-		if (move.from() == from && tempBoard.isMoveLegal(move))
+		if (move.from() == from)
 			moves.push_back(move);
 
 	return moves;
@@ -173,8 +173,7 @@ GameState BoardManager::getBoardState() noexcept
 	if (_currentBoard.isSideInCheck() && otherInCheck)
 		return GameState::INVALID;
 
-	MoveList moveList(_currentBoard);
-	moveList.keepLegalMoves();
+	const MoveList moveList(_currentBoard);
 
 	if (moveList.empty())
 	{
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <optional>
+
+#include "Defs.h"
+
+/**
+ * Small table owned by a single thread, where each Zobrist key has a single slot and always replaces its content.
+ * It needs no synchronization, so it is cheaper to use than the Transposition Table
+ */
+template <typename T>
+class DirectMappedCache
+{
+public:
+	explicit DirectMappedCache(const usize sizeKb)
+	{
+		// A power of two size, so that the index is just the low bits of the key
+		usize size = 2;
+		while (size * 2 * sizeof(Entry) <= (sizeKb << 10u))
+			size *= 2;
+
+		_mask = size - 1;
+		_entries = new Entry[size];
+		clear();
+	}
+
+	DirectMappedCache(const DirectMappedCache &) = delete;
+	DirectMappedCache(DirectMappedCache &&) = delete;
+	~DirectMappedCache() noexcept { delete[] _entries; }
+
+	DirectMappedCache &operator=(const DirectMappedCache &) = delete;
+	DirectMappedCache &operator=(DirectMappedCache &&) = delete;
+
+	[[nodiscard]] std::optional<T> probe(const u64 zKey) const noexcept
+	{
+		const Entry &entry = _entries[zKey & _mask];
+		if (entry.key == zKey)
+			return entry.value;
+
+		return {};
+	}
+
+	void insert(const u64 zKey, const T &value) noexcept
+	{
+		_entries[zKey & _mask] = Entry{ zKey, value };
+	}
+
+	void clear() noexcept
+	{
+		// An empty slot holds the key of a position that is stored in the next slot, so no probe can match it
+		for (usize i{}; i <= _mask; ++i)
+			_entries[i] = Entry{ u64(i + 1), T{} };
+	}
+
+private:
+	struct Entry
+	{
+		u64 key;
+		T value;
+	};
+
+	usize _mask{};
+	Entry *_entries = nullptr;
+};
@@ -19,7 +19,6 @@ public:
 			QSIDE_CASTLE = 1 << 3, // The move is a queen side castle
 			DOUBLE_PAWN_PUSH = 1 << 4, // The move is a double pawn push
 			EN_PASSANT = 1 << 5, // The move is an en passant capture (Do not set the CAPTURE flag too)
-			PV_MOVE = 1 << 6, // The move is a PV Move
 		};
 
 	public:
@@ -39,8 +38,6 @@ public:
 
 		[[nodiscard]] constexpr bool enPassant() const noexcept { return _flags & Internal::EN_PASSANT; }
 
-		[[nodiscard]] constexpr bool pvMove() const noexcept { return _flags & Internal::PV_MOVE; }
-
 	private:
 		u8 _flags;
 	};
@@ -2,43 +2,67 @@
 
 namespace
 {
-	enum class GenType
+	/**
+	 * The squares attacked by the enemy pieces, with our King removed from the board
+	 * so that it can't step back along the ray of a slider that is checking it
+	 */
+	template <Color Us>
+	Bitboard generateEnemyAttacks(const Board &board)
 	{
-		ALL,
-		CHECK_EVASION
-	};
+		constexpr Color Them{ ~Us };
 
-	template <Color Us>
-	void generatePawnMoves(const Board &board, MoveList &moveList, const Bitboard targets, const GenType type)
+		const Bitboard occupied = board.getPieces() ^ board.getPieces(KING, Us);
+
+		Bitboard attacks = Attacks::pawnAttacks<Them>(board.getPieces(PAWN, Them))
+						   | Attacks::kingAttacks(board.getKingSq(Them));
+
+		Bitboard knights = board.getPieces(KNIGHT, Them);
+		while (knights.notEmpty())
+			attacks |= Attacks::knightAttacks(knights.popLsb());
+
+		Bitboard bishops = board.getPieces(BISHOP, Them) | board.getPieces(QUEEN, Them);
+		while (bishops.notEmpty())
+			attacks |= Attacks::bishopAttacks(bishops.popLsb(), occupied);
+
+		Bitboard rooks = board.getPieces(ROOK, Them) | board.getPieces(QUEEN, Them);
+		while (rooks.notEmpty())
+			attacks |= Attacks::rookAttacks(rooks.popLsb(), occupied);
+
+		return attacks;
+	}
+
+	/**
+	 * Adds the moves of the given pawns, every destination square has to be part of targets.
+	 * The pins are not taken into account
+	 */
+	template <Color Us, GenType Type>
+	void addPawnMoves(const Board &board, MoveList &moveList, const Bitboard pawns, const Bitboard targets)
 	{
 		constexpr Color Them{ ~Us };
 		constexpr Dir Forward{ Us == WHITE ? NORTH : SOUTH };
 		constexpr Dir Backward{ Us == WHITE ? SOUTH : NORTH };
 		constexpr Bitboard ThirdRank{ Us == WHITE ? RANK_3 : RANK_6 };
 		constexpr Bitboard LastRank{ Us == WHITE ? RANK_7 : RANK_2 };
+		constexpr bool Tactical = Type != GenType::QUIETS && Type != GenType::QUIET_CHECKS;
 
-		const Bitboard pawns = board.getPieces(PAWN, Us);
 		const Bitboard pawnsOnLastRank = pawns & LastRank;
 		const Bitboard pawnsNotOnLastRank = pawns & ~pawnsOnLastRank;
 
-		const Bitboard enemies = type == GenType::CHECK_EVASION ? board.getKingAttackers() : board.getPieces(Them);
+		const Bitboard enemies = board.getPieces(Them) & targets;
 		const Bitboard emptySquares = ~board.getPieces();
 
-		// Promotions
-		if (pawnsOnLastRank.notEmpty())
+		// Promotions, all of them are generated together with the captures
+		if (Tactical && pawnsOnLastRank.notEmpty())
 		{
-			auto forward = pawnsOnLastRank.shift<Forward>() & emptySquares;
+			auto forward = pawnsOnLastRank.shift<Forward>() & emptySquares & targets;
 			auto left = pawnsOnLastRank.shift<Forward, WEST>() & enemies;
 			auto right = pawnsOnLastRank.shift<Forward, EAST>() & enemies;
 
-			if (type == GenType::CHECK_EVASION)
-				forward &= targets;
-
 			const auto makePromotions = [&](Square from, Square to)
 			{
 				const auto captured = board.getSquare(to).type();
 				u8 flags = Move::Flags::PROMOTION;
-				if (captured != PIECE_TYPE_NB)
+				if (captured != NO_PIECE_TYPE)
 					flags |= Move::Flags::CAPTURE;
 
 				Move move(from, to, PAWN, flags);
@@ -69,35 +93,12 @@ namespace
 			}
 		}
 
-		// EnPassant
-		const Square enPassantSq = board.getEnPassantSq();
-		if (enPassantSq != SQ_NONE)
-		{
-			const auto enPassant = Bitboard::fromSquare(enPassantSq);
-
-			if (type != GenType::CHECK_EVASION || (targets & enPassant.shift<Forward>()).empty())
-			{
-				auto pawnsThatCapture = Attacks::pawnAttacks<Them>(enPassant) & pawnsNotOnLastRank;
-
-				while (pawnsThatCapture.notEmpty())
-				{
-					const Square from = pawnsThatCapture.popLsb();
-					moveList.emplace_back(from, enPassantSq, PAWN, Move::Flags::EN_PASSANT);
-				}
-			}
-		}
-
 		// Captures
+		if constexpr (Tactical)
 		{
 			auto left = pawnsNotOnLastRank.shift<Forward, WEST>() & enemies;
 			auto right = pawnsNotOnLastRank.shift<Forward, EAST>() & enemies;
 
-			if (type == GenType::CHECK_EVASION)
-			{
-				left &= targets;
-				right &= targets;
-			}
-
 			const auto makeCapture = [&](Square from, Square to)
 			{
 				Move move(from, to, PAWN, Move::Flags::CAPTURE);
@@ -119,34 +120,85 @@ namespace
 		}
 
 		// Pushes and Double Pushes
-		auto pushes = pawnsNotOnLastRank.shift<Forward>() & emptySquares;
-		auto doublePushes = (pushes & ThirdRank).template shift<Forward>() & emptySquares;
-
-		if (type == GenType::CHECK_EVASION)
+		if constexpr (Type != GenType::CAPTURES)
 		{
+			auto pushes = pawnsNotOnLastRank.shift<Forward>() & emptySquares;
+			auto doublePushes = (pushes & ThirdRank).template shift<Forward>() & emptySquares & targets;
 			pushes &= targets;
-			doublePushes &= targets;
+
+			while (pushes.notEmpty())
+			{
+				const Square to = pushes.popLsb();
+				moveList.emplace_back(shift<Backward>(to), to, PAWN);
+			}
+
+			while (doublePushes.notEmpty())
+			{
+				const Square to = doublePushes.popLsb();
+				moveList.emplace_back(shift<Backward>(shift<Backward>(to)), to, PAWN, Move::Flags::DOUBLE_PAWN_PUSH);
+			}
 		}
+	}
 
-		while (pushes.notEmpty())
+	template <Color Us>
+	void generateEnPassant(const Board &board, MoveList &moveList, const Bitboard targets)
+	{
+		constexpr Color Them{ ~Us };
+		constexpr Dir Backward{ Us == WHITE ? SOUTH : NORTH };
+
+		const Square enPassantSq = board.getEnPassantSq();
+		if (enPassantSq == SQ_NONE)
+			return;
+
+		const auto enPassant = Bitboard::fromSquare(enPassantSq);
+
+		// When in check, the capture has to either remove the pawn giving check or block the attack
+		if ((targets & (enPassant | enPassant.shift<Backward>())).empty())
+			return;
+
+		auto pawnsThatCapture = Attacks::pawnAttacks<Them>(enPassant) & board.getPieces(PAWN, Us);
+
+		while (pawnsThatCapture.notEmpty())
 		{
-			const Square to = pushes.popLsb();
-			moveList.emplace_back(shift<Backward>(to), to, PAWN);
+			const Move move{ pawnsThatCapture.popLsb(), enPassantSq, PAWN, Move::Flags::EN_PASSANT };
+
+			// Both pawns leave their squares, which can uncover an attack on the King
+			if (board.isMoveLegal(move))
+				moveList.emplace_back(move);
 		}
+	}
+
+	template <Color Us, GenType Type>
+	void generatePawnMoves(const Board &board, MoveList &moveList, const Bitboard pawns, const Bitboard targets)
+	{
+		const Square kingSq = board.getKingSq(Us);
+		Bitboard pinnedPawns = pawns & board.getKingBlockers(Us);
 
-		while (doublePushes.notEmpty())
+		addPawnMoves<Us, Type>(board, moveList, pawns & ~pinnedPawns, targets);
+
+		// Pinned pawns can only move along the line between the King and the pinner
+		while (pinnedPawns.notEmpty())
 		{
-			const Square to = doublePushes.popLsb();
-			moveList.emplace_back(shift<Backward>(shift<Backward>(to)), to, PAWN, Move::Flags::DOUBLE_PAWN_PUSH);
+			const Square from = pinnedPawns.popLsb();
+			addPawnMoves<Us, Type>(board, moveList, Bitboard::fromSquare(from),
+								   targets & Bitboard::fromFullLine(kingSq, from));
 		}
+
+		if constexpr (Type != GenType::QUIETS && Type != GenType::QUIET_CHECKS)
+			generateEnPassant<Us>(board, moveList, targets);
 	}
 
 	template <Color Us, PieceType P>
-	void generatePieceMoves(const Board &board, MoveList &moveList, const Bitboard targets)
+	void generatePieceMoves(const Board &board, MoveList &moveList, Bitboard pieces, const Bitboard targets)
 	{
 		static_assert(P > PAWN && P < KING, "Unsupported Piece Type");
 
-		Bitboard pieces = board.getPieces(P, Us);
+		const Square kingSq = board.getKingSq(Us);
+		const Bitboard pinned = board.getKingBlockers(Us);
+
+		// A pinned Knight can never stay on the line of the pin
+		if constexpr (P == KNIGHT)
+			pieces &= ~pinned;
 
 		while (pieces.notEmpty())
 		{
@@ -165,6 +217,9 @@ namespace
 
 			attacks &= targets;
 
+			if (P != KNIGHT && (pinned & Bitboard::fromSquare(from)).notEmpty())
+				attacks &= Bitboard::fromFullLine(kingSq, from);
+
 			while (attacks.notEmpty())
 			{
 				const Square to = attacks.popLsb();
@@ -181,15 +236,13 @@ namespace
 		}
 	}
 
-	template <Color Us>
-	void generateKingMoves(const Board &board, MoveList &moveList, const Bitboard targets)
+	template <Color Us, GenType Type>
+	void generateKingMoves(const Board &board, MoveList &moveList, const Bitboard targets,
+						   const Bitboard enemyAttacks)
 	{
-		assert(board.getKingAttackers().empty());
-		constexpr Color Them{ ~Us };
-
 		const Square kingSq = board.getKingSq(Us);
 
-		Bitboard moves = Attacks::kingAttacks(kingSq) & targets;
+		Bitboard moves = Attacks::kingAttacks(kingSq) & targets & ~enemyAttacks;
 
 		while (moves.notEmpty())
 		{
@@ -205,9 +258,13 @@ namespace
 			moveList.emplace_back(move);
 		}
 
+		if (Type != GenType::ALL && Type != GenType::QUIETS)
+			return;
+
 		if (!board.canCastle<Us>())
 			return;
 
+		assert(board.getKingAttackers().empty());
 		assert(shiftToKingRank(Us, SQ_E1) == kingSq);
 
 		const auto addCastleMove = [&, kingSq](const Square kingTo, const Square rookSq,
@@ -221,14 +278,10 @@ namespace
 			if ((board.getPieces() & mask).notEmpty())
 				return;
 
-			// The King can't pass through a checked square
-			mask = Bitboard::fromBetween(kingSq, kingTo);
-			while (mask.notEmpty())
-			{
-				// TODO Move this in Board::isMoveLegal()
-				if (board.generateAttackers(Them, mask.popLsb(), board.getPieces()).notEmpty())
-					return;
-			}
+			// The King can't pass through or land on an attacked square
+			mask = Bitboard::fromBetween(kingSq, kingTo) | Bitboard::fromSquare(kingTo);
+			if ((enemyAttacks & mask).notEmpty())
+				return;
 
 			moveList.emplace_back(kingSq, kingTo, KING, castleSide);
 		};
@@ -255,63 +308,143 @@ namespace
 	}
 
 	template <Color Us>
-	void generateAllMoves(const Board &board, MoveList &moveList)
+	void generateEvasions(const Board &board, MoveList &moveList)
 	{
-		auto type = GenType::ALL;
-		auto targets = ~board.getPieces(Us); // Everywhere but our pieces
 		const auto kingAttackers = board.getKingAttackers();
+		assert(kingAttackers.notEmpty());
 
-		// When checked we must either capture the attacker
-		// or block it if is a slider piece
-		if (kingAttackers.notEmpty())
-		{
-			const Square kingSq = board.getKingSq(Us);
-			auto sliders = kingAttackers & ~(board.getPieces(PAWN) | board.getPieces(KNIGHT));
-			Bitboard sliderAttacks;
+		// The King can always try to step out of the attack
+		generateKingMoves<Us, GenType::EVASIONS>(board, moveList, ~board.getPieces(Us),
+												 generateEnemyAttacks<Us>(board));
 
-			while (sliders.notEmpty())
-				sliderAttacks |= Bitboard::fromLine(kingSq, sliders.popLsb()) & ~kingAttackers;
+		// We can't to anything else if there are two checkers
+		if (kingAttackers.several())
+			return;
 
-			// Evasions for king, capture and non capture moves
-			auto moves = Attacks::kingAttacks(kingSq) & ~board.getPieces(Us) & ~sliderAttacks;
-			while (moves.notEmpty())
-			{
-				const Square to = moves.popLsb();
+		// Otherwise the attacker must be captured, or blocked if it is a slider piece
+		const Square kingSq = board.getKingSq(Us);
+		const Square checkSq = kingAttackers.bitScanForward();
+		const auto targets = Bitboard::fromBetween(kingSq, checkSq) | kingAttackers;
+
+		generatePawnMoves<Us, GenType::EVASIONS>(board, moveList, board.getPieces(PAWN, Us), targets);
+		generatePieceMoves<Us, KNIGHT>(board, moveList, board.getPieces(KNIGHT, Us), targets);
+		generatePieceMoves<Us, BISHOP>(board, moveList, board.getPieces(BISHOP, Us), targets);
+		generatePieceMoves<Us, ROOK>(board, moveList, board.getPieces(ROOK, Us), targets);
+		generatePieceMoves<Us, QUEEN>(board, moveList, board.getPieces(QUEEN, Us), targets);
+	}
 
-				Move move{ kingSq, to, KING };
-				if (const PieceType capturedPiece = board.getSquare(to).type();
-					capturedPiece != NO_PIECE_TYPE)
-				{
-					move.setFlags(Move::Flags::CAPTURE);
-					move.setCapturedPiece(capturedPiece);
-				}
-				moveList.emplace_back(move);
-			}
+	template <Color Us>
+	void generateQuietChecks(const Board &board, MoveList &moveList)
+	{
+		constexpr Color Them{ ~Us };
+		assert(board.getKingAttackers().empty());
 
-			// We can't to anything else if there are two checkers
-			if (kingAttackers.several())
-				return;
+		const Square enemyKingSq = board.getKingSq(Them);
+		const Bitboard emptySquares = ~board.getPieces();
+
+		// Moving one of these pieces uncovers an attack on the enemy King
+		const Bitboard discoverers = board.getKingBlockers(Them) & board.getPieces(Us);
+
+		// Direct checks, the piece moves to a square from which it attacks the King
+		generatePawnMoves<Us, GenType::QUIET_CHECKS>(board, moveList, board.getPieces(PAWN, Us) & ~discoverers,
+													 emptySquares & board.getCheckSquares(PAWN));
+		generatePieceMoves<Us, KNIGHT>(board, moveList, board.getPieces(KNIGHT, Us) & ~discoverers,
+									   emptySquares & board.getCheckSquares(KNIGHT));
+		generatePieceMoves<Us, BISHOP>(board, moveList, board.getPieces(BISHOP, Us) & ~discoverers,
+									   emptySquares & board.getCheckSquares(BISHOP));
+		generatePieceMoves<Us, ROOK>(board, moveList, board.getPieces(ROOK, Us) & ~discoverers,
+									 emptySquares & board.getCheckSquares(ROOK));
+		generatePieceMoves<Us, QUEEN>(board, moveList, board.getPieces(QUEEN, Us) & ~discoverers,
+									  emptySquares & board.getCheckSquares(QUEEN));
+
+		// Discovered checks, the piece leaves the line between the slider and the King
+		Bitboard pieces = discoverers;
+		while (pieces.notEmpty())
+		{
+			const Square from = pieces.popLsb();
+			const auto fromBb = Bitboard::fromSquare(from);
+			const PieceType type = board.getSquare(from).type();
+			const Bitboard targets = emptySquares
+									 & (~Bitboard::fromFullLine(enemyKingSq, from) | board.getCheckSquares(type));
 
-			const Square checkSq = kingAttackers.bitScanForward();
-			targets &= Bitboard::fromBetween(kingSq, checkSq) | kingAttackers;
-			type = GenType::CHECK_EVASION;
+			switch (type)
+			{
+				case PAWN:
+					generatePawnMoves<Us, GenType::QUIET_CHECKS>(board, moveList, fromBb, targets);
+					break;
+				case KNIGHT:
+					generatePieceMoves<Us, KNIGHT>(board, moveList, fromBb, targets);
+					break;
+				case BISHOP:
+					generatePieceMoves<Us, BISHOP>(board, moveList, fromBb, targets);
+					break;
+				case ROOK:
+					generatePieceMoves<Us, ROOK>(board, moveList, fromBb, targets);
+					break;
+				case KING:
+					generateKingMoves<Us, GenType::QUIET_CHECKS>(board, moveList, targets,
+																 generateEnemyAttacks<Us>(board));
+					break;
+				default: // A Queen always attacks the King along the line it is blocking
+					break;
+			}
 		}
+	}
+
+	template <Color Us, GenType Type>
+	void generateMoves(const Board &board, MoveList &moveList)
+	{
+		static_assert(Type != GenType::EVASIONS);
+		assert(board.getKingAttackers().empty());
 
-		generatePawnMoves<Us>(board, moveList, targets, type);
-		generatePieceMoves<Us, KNIGHT>(board, moveList, targets);
-		generatePieceMoves<Us, BISHOP>(board, moveList, targets);
-		generatePieceMoves<Us, ROOK>(board, moveList, targets);
-		generatePieceMoves<Us, QUEEN>(board, moveList, targets);
+		Bitboard targets;
+		if constexpr (Type == GenType::ALL)
+			targets = ~board.getPieces(Us); // Everywhere but our pieces
+		else if constexpr (Type == GenType::CAPTURES)
+			targets = board.getPieces(~Us);
+		else if constexpr (Type == GenType::QUIETS)
+			targets = ~board.getPieces();
+
+		// Promotions by pushing a pawn are generated as captures, so the pawns can't be restricted to the targets
+		generatePawnMoves<Us, Type>(board, moveList, board.getPieces(PAWN, Us), ~board.getPieces(Us));
+		generatePieceMoves<Us, KNIGHT>(board, moveList, board.getPieces(KNIGHT, Us), targets);
+		generatePieceMoves<Us, BISHOP>(board, moveList, board.getPieces(BISHOP, Us), targets);
+		generatePieceMoves<Us, ROOK>(board, moveList, board.getPieces(ROOK, Us), targets);
+		generatePieceMoves<Us, QUEEN>(board, moveList, board.getPieces(QUEEN, Us), targets);
+		generateKingMoves<Us, Type>(board, moveList, targets, generateEnemyAttacks<Us>(board));
+	}
 
-		if (kingAttackers.empty())
-			generateKingMoves<Us>(board, moveList, targets);
+	template <Color Us>
+	void generateMovesOfType(const Board &board, MoveList &moveList, const GenType type)
+	{
+		switch (type)
+		{
+			case GenType::ALL:
+				if (board.getKingAttackers().notEmpty())
+					generateEvasions<Us>(board, moveList);
+				else
+					generateMoves<Us, GenType::ALL>(board, moveList);
+				break;
+			case GenType::CAPTURES:
+				generateMoves<Us, GenType::CAPTURES>(board, moveList);
+				break;
+			case GenType::QUIETS:
+				generateMoves<Us, GenType::QUIETS>(board, moveList);
+				break;
+			case GenType::EVASIONS:
+				generateEvasions<Us>(board, moveList);
+				break;
+			case GenType::QUIET_CHECKS:
+				generateQuietChecks<Us>(board, moveList);
+				break;
+		}
 	}
 }
 
-void MoveList::generateMoves() noexcept
+void MoveList::generateMoves(const GenType type) noexcept
 {
 	if (_board.colorToMove == WHITE)
-		generateAllMoves<WHITE>(_board, *this);
+		generateMovesOfType<WHITE>(_board, *this, type);
 	else
-		generateAllMoves<BLACK>(_board, *this);
+		generateMovesOfType<BLACK>(_board, *this, type);
 }
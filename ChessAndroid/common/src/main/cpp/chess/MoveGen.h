@@ -5,15 +5,37 @@
 #include "Move.h"
 #include "Board.h"
 
+/**
+ * Only legal moves are generated: pinned pieces are kept on the line of the pin
+ * and the King can't move to a square attacked by the enemy
+ */
+enum class GenType : u8
+{
+	ALL, // All the legal moves, or only the evasions if the side to move is in check
+	CAPTURES, // Captures, en passant and all the promotions, the side to move must not be in check
+	QUIETS, // All the other moves, including castling
+	EVASIONS, // Moves that get the king out of check
+	QUIET_CHECKS // The quiet moves that give check, except castling, the side to move must not be in check
+};
+
 class MoveList
 {
-	void generateMoves() noexcept;
+	friend class MovePicker;
+
+	struct NoGeneration {};
+
+	MoveList(Board &board, NoGeneration) noexcept
+		: _board(board), _end(begin())
+	{
+	}
+
+	void generateMoves(GenType type) noexcept;
 
 public:
-	explicit MoveList(Board &board)
+	explicit MoveList(Board &board, const GenType type = GenType::ALL)
 		: _board(board), _end(begin())
 	{
-		generateMoves();
+		generateMoves(type);
 	}
 
 	constexpr Move *begin() noexcept { return _moveList; }
@@ -53,20 +75,6 @@ public:
 		*_end++ = Move(std::forward<Args>(args)...);
 	}
 
-	void keepLegalMoves() noexcept
-	{
-		auto it = begin();
-		while (it != end())
-		{
-			if (!_board.isMoveLegal(*it))
-			{
-				*it = back();
-				popBack();
-			} else
-				++it;
-		}
-	}
-
 private:
 	Board &_board;
 	Move _moveList[MAX_MOVES];
@@ -77,11 +85,7 @@ inline bool moveExists(Board &board, const Move &move) noexcept
 {
 	const MoveList moveList(board);
 
-	for (const Move &m : moveList)
-		if (m == move)
-			return board.isMoveLegal(m);
-
-	return false;
+	return moveList.contains(move);
 }
 
 inline Move parseMove(Board &board, const std::string &str)
@@ -0,0 +1,246 @@
+#include "MovePicker.h"
+
+#include "algorithm/Evaluation.h"
+
+namespace
+{
+	constexpr int NormalScore = 1000000;
+	constexpr int EnPassantScore = 105;
+
+	constexpr std::array VictimScore = { 0, 100, 200, 300, 400, 500, 600 };
+	constexpr auto MvaLvv = []
+	{
+		std::array<std::array<int, PIECE_TYPE_NB>, PIECE_TYPE_NB> array{};
+
+		for (u8 attacker = PAWN; attacker <= KING; ++attacker)
+		{
+			for (u8 victim = PAWN; victim <= KING; ++victim)
+			{
+				array[victim][attacker] = VictimScore[victim] + 6 - VictimScore[attacker] / 100;
+			}
+		}
+
+		return array;
+	}();
+
+	int captureScore(const Move move) noexcept
+	{
+		const auto flags = move.flags();
+
+		if (flags.capture())
+			return MvaLvv[move.capturedPiece()][move.piece()];
+		if (flags.promotion())
+			return Evaluation::getPieceValue(move.promotedPiece());
+		return EnPassantScore;
+	}
+}
+
+MovePicker::MovePicker(const Thread &thread, Board &board, const Move ttMove) noexcept
+	: _thread(thread), _board(board),
+	  _stage(board.isSideInCheck() ? Stage::EVASIONS_TT_MOVE : Stage::TT_MOVE),
+	  _moveList(board, MoveList::NoGeneration{})
+{
+	_ttMove = validateTtMove(ttMove);
+}
+
+MovePicker::MovePicker(const Thread &thread, Board &board, const Move ttMove, const int qSearchDepth) noexcept
+	: MovePicker(thread, board, ttMove)
+{
+	if (_stage == Stage::EVASIONS_TT_MOVE)
+		return;
+
+	_stage = Stage::QS_TT_MOVE;
+	_quietChecks = qSearchDepth == 0;
+
+	// Only the captures and promotions are searched
+	if (!_ttMove.isTactical() && !_ttMove.flags().enPassant())
+		_ttMove = {};
+}
+
+Move MovePicker::nextMove() noexcept
+{
+	const auto nextStage = [this] { _stage = Stage(u8(_stage) + 1u); };
+
+	switch (_stage)
+	{
+		case Stage::TT_MOVE:
+		case Stage::EVASIONS_TT_MOVE:
+		case Stage::QS_TT_MOVE:
+			nextStage();
+			if (!_ttMove.empty())
+				return _ttMove;
+			return nextMove();
+
+		case Stage::GENERATE_CAPTURES:
+		case Stage::QS_GENERATE_CAPTURES:
+			_moveList.generateMoves(GenType::CAPTURES);
+			_current = _endBadCaptures = _moveList.begin();
+			scoreCaptures();
+			nextStage();
+			return nextMove();
+
+		case Stage::GOOD_CAPTURES:
+			while (_current != _moveList.end())
+			{
+				const Move move = *pickBest();
+				if (move == _ttMove)
+					continue;
+
+				if (_board.see(move))
+					return move;
+
+				// Captures that lose material are kept for later, at the start of the list
+				*_endBadCaptures++ = move;
+			}
+			nextStage();
+			return nextMove();
+
+		case Stage::KILLER_1:
+		case Stage::KILLER_2:
+		{
+			const usize index = _stage == Stage::KILLER_1 ? 0 : 1;
+			_killers[index] = validateKiller(_thread.killers[index][_board.ply]);
+			nextStage();
+
+			if (!_killers[index].empty())
+				return _killers[index];
+			return nextMove();
+		}
+
+		case Stage::GENERATE_QUIETS:
+			// The quiet moves are added after the captures
+			_current = _moveList.end();
+			_moveList.generateMoves(GenType::QUIETS);
+			scoreQuiets();
+			nextStage();
+			return nextMove();
+
+		case Stage::QUIETS:
+			while (_current != _moveList.end())
+			{
+				const Move move = *pickBest();
+				if (move != _ttMove && move != _killers[0] && move != _killers[1])
+					return move;
+			}
+			_current = _moveList.begin();
+			nextStage();
+			return nextMove();
+
+		case Stage::BAD_CAPTURES:
+			if (_current != _endBadCaptures)
+				return *_current++;
+			_stage = Stage::END;
+			return {};
+
+		case Stage::GENERATE_EVASIONS:
+			_moveList.generateMoves(GenType::EVASIONS);
+			_current = _moveList.begin();
+			scoreEvasions();
+			nextStage();
+			return nextMove();
+
+		case Stage::EVASIONS:
+		case Stage::QS_CAPTURES:
+			while (_current != _moveList.end())
+			{
+				const Move move = *pickBest();
+				if (move != _ttMove)
+					return move;
+			}
+
+			if (_stage == Stage::QS_CAPTURES && _quietChecks)
+			{
+				nextStage();
+				return nextMove();
+			}
+			_stage = Stage::END;
+			return {};
+
+		case Stage::QS_GENERATE_QUIET_CHECKS:
+			// The checks are added after the captures
+			_current = _moveList.end();
+			_moveList.generateMoves(GenType::QUIET_CHECKS);
+			scoreQuiets();
+			nextStage();
+			return nextMove();
+
+		case Stage::QS_QUIET_CHECKS:
+			while (_current != _moveList.end())
+			{
+				const Move move = *pickBest();
+				if (move != _ttMove)
+					return move;
+			}
+			_stage = Stage::END;
+			return {};
+
+		case Stage::END:
+			break;
+	}
+
+	return {};
+}
+
+Move MovePicker::validateTtMove(const Move ttMove) const noexcept
+{
+	if (ttMove.empty())
+		return {};
+
+	// The move may come from another position with the same key
+	const Move move = _board.getPseudoLegalMove(ttMove.from(), ttMove.to(), ttMove.promotedPiece());
+	if (move.empty() || !_board.isMoveLegal(move))
+		return {};
+
+	return move;
+}
+
+Move MovePicker::validateKiller(const u32 killer) const noexcept
+{
+	const Move move{ killer };
+
+	if (move.empty() || move == _ttMove || move == _killers[0])
+		return {};
+
+	// Killers come from sibling nodes, so they must still be quiet moves in this position
+	if (move.isTactical() || move.flags().enPassant()
+		|| _board.getPseudoLegalMove(move.from(), move.to(), move.promotedPiece()) != move
+		|| !_board.isMoveLegal(move))
+		return {};
+
+	return move;
+}
+
+void MovePicker::scoreCaptures() noexcept
+{
+	for (auto it = _current; it != _moveList.end(); ++it)
+		it->setScore(captureScore(*it));
+}
+
+void MovePicker::scoreQuiets() noexcept
+{
+	for (auto it = _current; it != _moveList.end(); ++it)
+		it->setScore(_thread.history[it->from()][it->to()]);
+}
+
+void MovePicker::scoreEvasions() noexcept
+{
+	for (auto it = _current; it != _moveList.end(); ++it)
+	{
+		if (it->isTactical() || it->flags().enPassant())
+			it->setScore(captureScore(*it) + NormalScore);
+		else
+			it->setScore(_thread.history[it->from()][it->to()]);
+	}
+}
+
+Move *MovePicker::pickBest() noexcept
+{
+	Move *best = _current;
+
+	for (auto it = _current + 1; it < _moveList.end(); ++it)
+		if (it->getScore() > best->getScore())
+			best = it;
+
+	std::swap(*best, *_current);
+	return _current++;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "MoveGen.h"
+#include "Thread.h"
+
+class Board;
+
+/**
+ * Returns the moves of a position one at a time, generating them in stages:
+ * each stage is only generated if none of the moves returned before caused a cutoff
+ */
+class MovePicker final
+{
+	enum class Stage : u8
+	{
+		TT_MOVE,
+		GENERATE_CAPTURES,
+		GOOD_CAPTURES,
+		KILLER_1,
+		KILLER_2,
+		GENERATE_QUIETS,
+		QUIETS,
+		BAD_CAPTURES,
+
+		EVASIONS_TT_MOVE,
+		GENERATE_EVASIONS,
+		EVASIONS,
+
+		QS_TT_MOVE,
+		QS_GENERATE_CAPTURES,
+		QS_CAPTURES,
+		QS_GENERATE_QUIET_CHECKS,
+		QS_QUIET_CHECKS,
+
+		END
+	};
+
+public:
+	/**
+	 * Used by the main search, returns all the legal moves
+	 */
+	MovePicker(const Thread &thread, Board &board, Move ttMove) noexcept;
+
+	/**
+	 * Used by the quiescence search, returns only the captures and promotions, or all the evasions when in check.
+	 * At its first ply (depth 0), the quiet moves that give check are returned after the captures
+	 */
+	MovePicker(const Thread &thread, Board &board, Move ttMove, int qSearchDepth) noexcept;
+
+	/**
+	 * @return the next legal move, or an empty move once all of them have been returned
+	 */
+	[[nodiscard]] Move nextMove() noexcept;
+
+	[[nodiscard]] Move ttMove() const noexcept { return _ttMove; }
+
+private:
+	[[nodiscard]] Move validateTtMove(Move ttMove) const noexcept;
+	[[nodiscard]] Move validateKiller(u32 killer) const noexcept;
+
+	void scoreCaptures() noexcept;
+	void scoreQuiets() noexcept;
+	void scoreEvasions() noexcept;
+
+	[[nodiscard]] Move *pickBest() noexcept;
+
+	const Thread &_thread;
+	Board &_board;
+	Stage _stage;
+	Move _ttMove;
+	std::array<Move, 2> _killers{};
+	bool _quietChecks{};
+
+	MoveList _moveList;
+	Move *_current{};
+	Move *_endBadCaptures{};
+};
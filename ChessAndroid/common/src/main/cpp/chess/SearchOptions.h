@@ -2,8 +2,10 @@
 
 #include <algorithm>
 #include <thread>
+#include <vector>
 
 #include "Defs.h"
+#include "Move.h"
 
 class SearchOptions final
 {
@@ -32,16 +34,91 @@ public:
 
 	[[nodiscard]] constexpr auto tableSizeMb() const noexcept { return _cacheTableSizeMb; }
 
-	[[nodiscard]] constexpr bool isTimeSet() const noexcept { return _searchTime != 0ull; }
+	[[nodiscard]] constexpr bool isTimeSet() const noexcept { return _searchTime != 0 || _timeLeft != 0; }
 
+	/**
+	 * Fixed amount of time that should be spent on this move
+	 */
 	[[nodiscard]] constexpr auto searchTime() const noexcept { return _searchTime; }
 
 	[[nodiscard]] constexpr bool quietSearch() const noexcept { return _quiescenceSearch; }
 
+	/**
+	 * Sets the clock of the side to move, the Time Manager decides how much of it to use for this move
+	 */
+	constexpr void setClock(const i64 timeLeft, const i64 increment, const i32 movesToGo) noexcept
+	{
+		_timeLeft = std::max<i64>(timeLeft, 0);
+		_increment = std::max<i64>(increment, 0);
+		_movesToGo = std::max<i32>(movesToGo, 0);
+	}
+
+	[[nodiscard]] constexpr auto timeLeft() const noexcept { return _timeLeft; }
+
+	[[nodiscard]] constexpr auto increment() const noexcept { return _increment; }
+
+	/**
+	 * Moves until the next time control, 0 if the rest of the game has to be played with the time left
+	 */
+	[[nodiscard]] constexpr auto movesToGo() const noexcept { return _movesToGo; }
+
+	/**
+	 * Time reserved for each move to make up for the communication delays with the GUI
+	 */
+	constexpr void setMoveOverhead(const i64 moveOverhead) noexcept { _moveOverhead = std::max<i64>(moveOverhead, 0); }
+
+	[[nodiscard]] constexpr auto moveOverhead() const noexcept { return _moveOverhead; }
+
+	/**
+	 * Stops the search once all the threads have searched this many nodes, 0 means no limit
+	 */
+	constexpr void setNodesLimit(const u64 nodes) noexcept { _nodesLimit = nodes; }
+
+	[[nodiscard]] constexpr bool isNodesLimitSet() const noexcept { return _nodesLimit != 0; }
+
+	[[nodiscard]] constexpr auto nodesLimit() const noexcept { return _nodesLimit; }
+
+	/**
+	 * The search is done on the opponent's time, it may only stop once the ponder move is played or it is stopped
+	 */
+	constexpr void setPonder(const bool ponder) noexcept { _ponder = ponder; }
+
+	[[nodiscard]] constexpr bool ponder() const noexcept { return _ponder; }
+
+	/**
+	 * The search may only stop once it is told to, even if there is nothing left to search
+	 */
+	constexpr void setInfinite(const bool infinite) noexcept { _infinite = infinite; }
+
+	[[nodiscard]] constexpr bool infinite() const noexcept { return _infinite; }
+
+	/**
+	 * Number of best lines that are searched and reported, each one with a different first move
+	 */
+	constexpr void setMultiPv(const usize multiPv) noexcept { _multiPv = std::max<usize>(multiPv, 1u); }
+
+	[[nodiscard]] constexpr auto multiPv() const noexcept { return _multiPv; }
+
+	/**
+	 * Restricts the search to these root moves, all legal moves are searched if it is empty
+	 */
+	void setSearchMoves(std::vector<Move> moves) noexcept { _searchMoves = std::move(moves); }
+
+	[[nodiscard]] const auto &searchMoves() const noexcept { return _searchMoves; }
+
 private:
 	i32 _depth;
 	usize _threadCount;
 	usize _cacheTableSizeMb;
 	i64 _searchTime;
+	i64 _timeLeft{};
+	i64 _increment{};
+	i32 _movesToGo{};
+	i64 _moveOverhead{};
+	u64 _nodesLimit{};
+	bool _ponder{};
+	bool _infinite{};
+	usize _multiPv{ 1 };
+	std::vector<Move> _searchMoves{};
 	bool _quiescenceSearch;
 };
@@ -6,9 +6,16 @@ std::atomic_bool Stats::_statsEnabled{ false };
 std::chrono::time_point<std::chrono::high_resolution_clock> Stats::_startTime;
 std::atomic_size_t Stats::_boardsEvaluated;
 std::atomic_size_t Stats::_nodesSearched;
+std::atomic_size_t Stats::_qNodesSearched;
 std::atomic_size_t Stats::_nullCuts;
 std::atomic_size_t Stats::_futilityCuts;
 std::atomic_size_t Stats::_lmrCount;
+std::atomic_size_t Stats::_ttProbes;
+std::atomic_size_t Stats::_ttHits;
+std::atomic_size_t Stats::_qCacheProbes;
+std::atomic_size_t Stats::_qCacheHits;
+std::atomic_size_t Stats::_ttEvals;
+std::atomic_size_t Stats::_evalCacheHits;
 
 void Stats::setEnabled(const bool enabled) noexcept
 {
@@ -19,9 +26,16 @@ void Stats::resetStats() noexcept
 {
 	_boardsEvaluated = 0;
 	_nodesSearched = 0;
+	_qNodesSearched = 0;
 	_nullCuts = 0;
 	_futilityCuts = 0;
 	_lmrCount = 0;
+	_ttProbes = 0;
+	_ttHits = 0;
+	_qCacheProbes = 0;
+	_qCacheHits = 0;
+	_ttEvals = 0;
+	_evalCacheHits = 0;
 }
 
 void Stats::incBoardsEvaluated() noexcept
@@ -36,6 +50,12 @@ void Stats::incNodesSearched(const usize amount) noexcept
 		_nodesSearched += amount;
 }
 
+void Stats::incQNodesSearched() noexcept
+{
+	if (_statsEnabled)
+		++_qNodesSearched;
+}
+
 void Stats::incNullCuts() noexcept
 {
 	if (_statsEnabled)
@@ -54,6 +74,36 @@ void Stats::incLmrCount() noexcept
 		++_lmrCount;
 }
 
+void Stats::incTtProbes(const bool hit) noexcept
+{
+	if (_statsEnabled)
+	{
+		++_ttProbes;
+		_ttHits += hit;
+	}
+}
+
+void Stats::incQCacheProbes(const bool hit) noexcept
+{
+	if (_statsEnabled)
+	{
+		++_qCacheProbes;
+		_qCacheHits += hit;
+	}
+}
+
+void Stats::incTtEvals() noexcept
+{
+	if (_statsEnabled)
+		++_ttEvals;
+}
+
+void Stats::incEvalCacheHits() noexcept
+{
+	if (_statsEnabled)
+		++_evalCacheHits;
+}
+
 void Stats::restartTimer() noexcept
 {
 	_startTime = std::chrono::high_resolution_clock::now();
@@ -77,16 +127,27 @@ std::string Stats::formatStats(const char separator)
 	{
 		const auto boardsEvaluated = static_cast<usize>(_boardsEvaluated);
 		const auto nodesSearched = static_cast<usize>(_nodesSearched);
+		const auto qNodesSearched = static_cast<usize>(_qNodesSearched);
 		const auto nullCuts = static_cast<usize>(_nullCuts);
 		const auto futilityCuts = static_cast<usize>(_futilityCuts);
 		const auto lmrCount = static_cast<usize>(_lmrCount);
+		const auto ttProbes = static_cast<usize>(_ttProbes);
+		const auto ttHits = static_cast<usize>(_ttHits);
+		const auto qCacheProbes = static_cast<usize>(_qCacheProbes);
+		const auto qCacheHits = static_cast<usize>(_qCacheHits);
+		const auto ttEvals = static_cast<usize>(_ttEvals);
+		const auto evalCacheHits = static_cast<usize>(_evalCacheHits);
 		const usize nps = timeMs ? static_cast<usize>(nodesSearched / (timeMs / 1000.0)) : 0ul;
 
 		stream << "Boards Evaluated: " << boardsEvaluated << separator
 			   << "Nodes Searched: " << nodesSearched << separator
+			   << "QSearch Nodes: " << qNodesSearched << separator
 			   << "Nps: " << nps << separator
 			   << "Null: " << nullCuts << separator
-			   << "Futility/LMR: " << futilityCuts << '/' << lmrCount << separator;
+			   << "Futility/LMR: " << futilityCuts << '/' << lmrCount << separator
+			   << "TT Hits: " << ttHits << '/' << ttProbes << separator
+			   << "QSearch Cache Hits: " << qCacheHits << '/' << qCacheProbes << separator
+			   << "Evals Avoided (TT/Cache): " << ttEvals << '/' << evalCacheHits << separator;
 	}
 
 	return stream.str();
@@ -13,9 +13,16 @@ class Stats final
 
 	static std::atomic_size_t _boardsEvaluated;
 	static std::atomic_size_t _nodesSearched;
+	static std::atomic_size_t _qNodesSearched;
 	static std::atomic_size_t _nullCuts;
 	static std::atomic_size_t _futilityCuts;
 	static std::atomic_size_t _lmrCount;
+	static std::atomic_size_t _ttProbes;
+	static std::atomic_size_t _ttHits;
+	static std::atomic_size_t _qCacheProbes;
+	static std::atomic_size_t _qCacheHits;
+	static std::atomic_size_t _ttEvals;
+	static std::atomic_size_t _evalCacheHits;
 
 public:
 	Stats() = delete;
@@ -29,9 +36,14 @@ public:
 
 	static void incBoardsEvaluated() noexcept;
 	static void incNodesSearched(usize amount = 1u) noexcept;
+	static void incQNodesSearched() noexcept;
 	static void incNullCuts() noexcept;
 	static void incFutilityCuts() noexcept;
 	static void incLmrCount() noexcept;
+	static void incTtProbes(bool hit) noexcept;
+	static void incQCacheProbes(bool hit) noexcept;
+	static void incTtEvals() noexcept;
+	static void incEvalCacheHits() noexcept;
 
 	static void restartTimer() noexcept;
 	static i64 getElapsedMs() noexcept;
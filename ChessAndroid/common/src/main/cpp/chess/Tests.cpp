@@ -1,19 +1,138 @@
 #include "Tests.h"
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <random>
 #include <sstream>
+#include <thread>
 #include <vector>
 #include <string_view>
 
+#ifdef __linux__
+#	include <dirent.h>
+#	include <linux/perf_event.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#	ifndef __ANDROID__
+#		include <spawn.h>
+#		include <sys/wait.h>
+#	endif
+#endif
+
 #include "Board.h"
 #include "MoveGen.h"
+#include "TranspositionTable.h"
+#include "algorithm/Attacks.h"
 #include "algorithm/Evaluation.h"
+#include "algorithm/Search.h"
 
 namespace Tests
 {
+	/**
+	 * Positions used by both the evaluation tests and the benchmark
+	 */
+	static constexpr std::array TestPositions = {
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ",
+		"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w",
+		"8/8/p1p5/1p5p/1P5p/8/PPP2K1p/4R1rk w",
+		"1q1k4/2Rr4/8/2Q3K1/8/8/8/8 w",
+		"7k/5K2/5P1p/3p4/6P1/3p4/8/8 w",
+		"8/6B1/p5p1/Pp4kp/1P5r/5P1Q/4q1PK/8 w",
+		"8/8/1p1r1k2/p1pPN1p1/P3KnP1/1P6/8/3R4 b",
+		"1r2r1k1/1pqbbppp/p2p1n2/4p3/P3PP2/2N1BB2/1PP2QPP/R4R1K b",
+		"r1bk1bnr/ppp2ppp/8/4n3/2P5/P3B3/1P3PPP/RN2KBNR w KQ",
+		"8/7p/3k2p1/6P1/4KP2/8/7P/8 w",
+		"r1b1r1k1/1p1n1pbp/2p1n1p1/q1P1p3/4P3/1PN1BNPP/2Q2PB1/1R1R2K1 w",
+		"1rN1r1k1/1pq2pp1/2p1nn1p/p2p1B2/3P4/4P2P/PPQ1NPP1/2R2RK1 b",
+		"3r1rk1/p1q2pbp/1np1p1p1/1p2P3/5P2/2N2Q1P/PPP3P1/3RRBK1 b",
+		"r2r2k1/p3ppbp/1p4p1/3p4/3P4/2P1P2P/P3BPP1/2R2RK1 w",
+		"2rq3r/pb1pbkpp/1p2pp2/n1P5/2P5/QP2BNPB/P3PP1P/3R1RK1 w",
+		"1r1q1rk1/pp1bbppp/2n1p1n1/4P3/2BpN3/3P1N2/PP2QPPP/R1B1R1K1 b",
+		"3r2k1/2p2ppp/1p1br3/pPn5/3PP3/P7/1B1N2PP/R3R1K1 w",
+		"r4rk1/p2qn1bp/1pnp2p1/2p2p2/4PP1N/2PPB3/PP2QN1P/R4RK1 b",
+		"r3r1k1/1b1n1p2/1q1p1n1p/2p1p2P/p1P3p1/P1QNPPB1/1P2B1P1/2KR3R w",
+		"1rb1nrk1/2q1bppp/p1n1p3/2p1P3/2Pp1PP1/3P1NN1/P5BP/R1BQ1RK1 w",
+		"r3r1k1/ppqbbpp1/2pp1nnp/3Pp3/2P1P3/5N1P/PPBN1PP1/R1BQR1K1 w",
+		"5r1k/1q2rnpp/p4p2/1pp5/6Q1/1P3P2/PBP3PP/3RR1K1 w",
+		"2r2k2/5p2/2Bp1b1r/2qPp1pp/PpN1P3/1P2Q3/5PPP/4R1K1 w",
+		"1k1r4/pp1b1R2/3q2pp/4p3/2B5/4Q3/PPP2B2/2K5 b",
+		"3r1k2/4npp1/1ppr3p/p6P/P2PPPP1/1NR5/5K2/2R5 w",
+		"2q1rr1k/3bbnnp/p2p1pp1/2pPp3/PpP1P1P1/1P2BNNP/2BQ1PRK/7R b",
+		"rnbqkb1r/p3pppp/1p6/2ppP3/3N4/2P5/PPP1QPPP/R1B1KB1R w KQkq",
+		"r1b2rk1/2q1b1pp/p2ppn2/1p6/3QP3/1BN1B3/PPP3PP/R4RK1 w",
+		"2r3k1/pppR1pp1/4p3/4P1P1/5P2/1P4K1/P1P5/8 w",
+		"1nk1r1r1/pp2n1pp/4p3/q2pPp1N/b1pP1P2/B1P2R2/2P1B1PP/R2Q2K1 w",
+		"4b3/p3kp2/6p1/3pP2p/2pP1P2/4K1P1/P3N2P/8 w",
+		"2kr1bnr/pbpq4/2n1pp2/3p3p/3P1P1B/2N2N1Q/PPP3PP/2KR1B1R w",
+		"3rr1k1/pp3pp1/1qn2np1/8/3p4/PP1R1P2/2P1NQPP/R1B3K1 b",
+		"2r1nrk1/p2q1ppp/bp1p4/n1pPp3/P1P1P3/2PBB1N1/4QPPP/R4RK1 w",
+		"r3r1k1/ppqb1ppp/8/4p1NQ/8/2P5/PP3PPP/R3R1K1 b",
+		"r2q1rk1/4bppp/p2p4/2pP4/3pP3/3Q4/PP1B1PPP/R3R1K1 w",
+		"rnb2r1k/pp2p2p/2pp2p1/q2P1p2/8/1Pb2NP1/PB2PPBP/R2Q1RK1 w",
+		"2r3k1/1p2q1pp/2b1pr2/p1pp4/6Q1/1P1PP1R1/P1PN2PP/5RK1 w",
+		"r1bqkb1r/4npp1/p1p4p/1p1pP1B1/8/1B6/PPPN1PPP/R2Q1RK1 w kq",
+		"r2q1rk1/1ppnbppp/p2p1nb1/3Pp3/2P1P1P1/2N2N1P/PPB1QP2/R1B2RK1 b",
+		"r1bq1rk1/pp2ppbp/2np2p1/2n5/P3PP2/N1P2N2/1PB3PP/R1B1QRK1 b",
+		"3rr3/2pq2pk/p2p1pnp/8/2QBPP2/1P6/P5PP/4RRK1 b",
+		"r4k2/pb2bp1r/1p1qp2p/3pNp2/3P1P2/2N3P1/PPP1Q2P/2KRR3 w",
+		"3rn2k/ppb2rpp/2ppqp2/5N2/2P1P3/1P5Q/PB3PPP/3RR1K1 w",
+		"2r2rk1/1bqnbpp1/1p1ppn1p/pP6/N1P1P3/P2B1N1P/1B2QPP1/R2R2K1 b",
+		"r1bqk2r/pp2bppp/2p5/3pP3/P2Q1P2/2N1B3/1PP3PP/R4RK1 b kq",
+		"r2qnrnk/p2b2b1/1p1p2pp/2pPpp2/1PP1P3/PRNBB3/3QNPPP/5RK1 w",
+		"4Q3/6pk/2pq4/3p4/1p1P3p/1P1K1P2/1PP3P1/8 b",
+		"8/5pk1/4p3/7Q/8/3q4/KP6/8 b",
+		"r3bb2/P1q3k1/Q2p3p/2pPp1pP/2B1P3/2B5/6P1/R5K1 w",
+		"r1b5/p2k1r1p/3P2pP/1ppR4/2P2p2/2P5/P1B4P/4R1K1 w",
+		"6r1/1p3k2/pPp4R/K1P1p1p1/1P2Pp1p/5P1P/6P1/8 w",
+		"1k2b3/4bpp1/p2pp1P1/1p3P2/2q1P3/4B3/PPPQN2r/1K1R4 w",
+		"2kr3r/ppp1qpp1/2p5/2b2b2/2P1pPP1/1P2P1p1/PBQPB3/RN2K1R1 b",
+		"6k1/2q3p1/1n2Pp1p/pBp2P2/Pp2P3/1P1Q1KP1/8/8 w",
+		"5r2/pp1RRrk1/4Qq1p/1PP3p1/8/4B3/1b3P1P/6K1 w",
+		"6k1/1q2rpp1/p6p/P7/1PB1n3/5Q2/6PP/5R1K w",
+		"3r2k1/p6p/b2r2p1/2qPQp2/2P2P2/8/6BP/R4R1K w",
+		"8/6Bp/6p1/2k1p3/4PPP1/1pb4P/8/2K5 b",
+		"2r1rbk1/p1Bq1ppp/Ppn1b3/1Npp4/B7/3P2Q1/1PP2PPP/R4RK1 w",
+		"r4rk1/ppq3pp/2p1Pn2/4p1Q1/8/2N5/PP4PP/2KR1R2 w",
+		"6k1/p4pp1/Pp2r3/1QPq3p/8/6P1/2P2P1P/1R4K1 w",
+		"8/2k5/2p5/2pb2K1/pp4P1/1P1R4/P7/8 b",
+		"2r5/1r5k/1P3p2/PR2pP1p/4P2p/2p1BP2/1p2n3/4R2K b",
+		"8/1R2P3/6k1/3B4/2P2P2/1p2r3/1Kb4p/8 w",
+		"1q1r3k/3P1pp1/ppBR1n1p/4Q2P/P4P2/8/5PK1/8 w",
+		"6k1/5pp1/pb1r3p/8/2q1P3/1p3N1P/1P3PP1/2R1Q1K1 b",
+		"8/Bpk5/8/P2K4/8/8/8/8 w",
+		"1r6/5k2/p4p1K/5R2/7P/8/6P1/8 w",
+		"8/6k1/p4p2/P3q2p/7P/5Q2/5PK1/8 w",
+		"8/8/6p1/3Pkp2/4P3/2K5/6P1/n7 w",
+		"1k1r4/pp1b1R2/3q2pp/4p3/2B5/4Q3/PPP2B2/2K5 b",
+		"q1rr1k/3bbnnp/p2p1pp1/2pPp3/PpP1P1P1/1P2BNNP/2BQ1PRK/7R b",
+		"r1b2rk1/2q1b1pp/p2ppn2/1p6/3QP3/1BN1B3/PPP3PP/R4RK1 w",
+		"2r3k1/pppR1pp1/4p3/4P1P1/5P2/1P4K1/P1P5/8 w",
+		"1nk1r1r1/pp2n1pp/4p3/q2pPp1N/b1pP1P2/B1P2R2/2P1B1PP/R2Q2K1 w",
+		"4b3/p3kp2/6p1/3pP2p/2pP1P2/4K1P1/P3N2P/8 w",
+		"2kr1bnr/pbpq4/2n1pp2/3p3p/3P1P1B/2N2N1Q/PPP3PP/2KR1B1R w",
+		"3rr1k1/pp3pp1/1qn2np1/8/3p4/PP1R1P2/2P1NQPP/R1B3K1 b",
+		"2r1nrk1/p2q1ppp/bp1p4/n1pPp3/P1P1P3/2PBB1N1/4QPPP/R4RK1 w",
+		"r3r1k1/ppqb1ppp/8/4p1NQ/8/2P5/PP3PPP/R3R1K1 b",
+		"r2q1rk1/4bppp/p2p4/2pP4/3pP3/3Q4/PP1B1PPP/R3R1K1 w",
+		"rnb2r1k/pp2p2p/2pp2p1/q2P1p2/8/1Pb2NP1/PB2PPBP/R2Q1RK1 w",
+		"2r3k1/1p2q1pp/2b1pr2/p1pp4/6Q1/1P1PP1R1/P1PN2PP/5RK1 w",
+		"r1bqkb1r/4npp1/p1p4p/1p1pP1B1/8/1B6/PPPN1PPP/R2Q1RK1 w kq",
+		"r2q1rk1/1ppnbppp/p2p1nb1/3Pp3/2P1P1P1/2N2N1P/PPB1QP2/R1B2RK1 b",
+		"r1bq1rk1/pp2ppbp/2np2p1/2n5/P3PP2/N1P2N2/1PB3PP/R1B1QRK1 b",
+		"3rr3/2pq2pk/p2p1pnp/8/2QBPP2/1P6/P5PP/4RRK1 b",
+		"r4k2/pb2bp1r/1p1qp2p/3pNp2/3P1P2/2N3P1/PPP1Q2P/2KRR3 w",
+		"3rn2k/ppb2rpp/2ppqp2/5N2/2P1P3/1P5Q/PB3PPP/3RR1K1 w",
+		"2r2rk1/1bqnbpp1/1p1ppn1p/pP6/N1P1P3/P2B1N1P/1B2QPP1/R2R2K1 b",
+		"r1bqk2r/pp2bppp/2p5/3pP3/P2Q1P2/2N1B3/1PP3PP/R4RK1 b kq",
+		"r2qnrnk/p2b2b1/1p1p2pp/2pPpp2/1PP1P3/PRNBB3/3QNPPP/5RK1 w"
+	};
+
 	// region Evaluation
 
 	static Board mirrorBoard(const Board &board)
@@ -58,108 +177,10 @@ namespace Tests
 
 	std::string runEvaluationTests() noexcept
 	{
-		static constexpr std::array Positions = {
-			"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq",
-			"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq",
-			"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq",
-			"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ",
-			"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w",
-			"8/8/p1p5/1p5p/1P5p/8/PPP2K1p/4R1rk w",
-			"1q1k4/2Rr4/8/2Q3K1/8/8/8/8 w",
-			"7k/5K2/5P1p/3p4/6P1/3p4/8/8 w",
-			"8/6B1/p5p1/Pp4kp/1P5r/5P1Q/4q1PK/8 w",
-			"8/8/1p1r1k2/p1pPN1p1/P3KnP1/1P6/8/3R4 b",
-			"1r2r1k1/1pqbbppp/p2p1n2/4p3/P3PP2/2N1BB2/1PP2QPP/R4R1K b",
-			"r1bk1bnr/ppp2ppp/8/4n3/2P5/P3B3/1P3PPP/RN2KBNR w KQ",
-			"8/7p/3k2p1/6P1/4KP2/8/7P/8 w",
-			"r1b1r1k1/1p1n1pbp/2p1n1p1/q1P1p3/4P3/1PN1BNPP/2Q2PB1/1R1R2K1 w",
-			"1rN1r1k1/1pq2pp1/2p1nn1p/p2p1B2/3P4/4P2P/PPQ1NPP1/2R2RK1 b",
-			"3r1rk1/p1q2pbp/1np1p1p1/1p2P3/5P2/2N2Q1P/PPP3P1/3RRBK1 b",
-			"r2r2k1/p3ppbp/1p4p1/3p4/3P4/2P1P2P/P3BPP1/2R2RK1 w",
-			"2rq3r/pb1pbkpp/1p2pp2/n1P5/2P5/QP2BNPB/P3PP1P/3R1RK1 w",
-			"1r1q1rk1/pp1bbppp/2n1p1n1/4P3/2BpN3/3P1N2/PP2QPPP/R1B1R1K1 b",
-			"3r2k1/2p2ppp/1p1br3/pPn5/3PP3/P7/1B1N2PP/R3R1K1 w",
-			"r4rk1/p2qn1bp/1pnp2p1/2p2p2/4PP1N/2PPB3/PP2QN1P/R4RK1 b",
-			"r3r1k1/1b1n1p2/1q1p1n1p/2p1p2P/p1P3p1/P1QNPPB1/1P2B1P1/2KR3R w",
-			"1rb1nrk1/2q1bppp/p1n1p3/2p1P3/2Pp1PP1/3P1NN1/P5BP/R1BQ1RK1 w",
-			"r3r1k1/ppqbbpp1/2pp1nnp/3Pp3/2P1P3/5N1P/PPBN1PP1/R1BQR1K1 w",
-			"5r1k/1q2rnpp/p4p2/1pp5/6Q1/1P3P2/PBP3PP/3RR1K1 w",
-			"2r2k2/5p2/2Bp1b1r/2qPp1pp/PpN1P3/1P2Q3/5PPP/4R1K1 w",
-			"1k1r4/pp1b1R2/3q2pp/4p3/2B5/4Q3/PPP2B2/2K5 b",
-			"3r1k2/4npp1/1ppr3p/p6P/P2PPPP1/1NR5/5K2/2R5 w",
-			"2q1rr1k/3bbnnp/p2p1pp1/2pPp3/PpP1P1P1/1P2BNNP/2BQ1PRK/7R b",
-			"rnbqkb1r/p3pppp/1p6/2ppP3/3N4/2P5/PPP1QPPP/R1B1KB1R w KQkq",
-			"r1b2rk1/2q1b1pp/p2ppn2/1p6/3QP3/1BN1B3/PPP3PP/R4RK1 w",
-			"2r3k1/pppR1pp1/4p3/4P1P1/5P2/1P4K1/P1P5/8 w",
-			"1nk1r1r1/pp2n1pp/4p3/q2pPp1N/b1pP1P2/B1P2R2/2P1B1PP/R2Q2K1 w",
-			"4b3/p3kp2/6p1/3pP2p/2pP1P2/4K1P1/P3N2P/8 w",
-			"2kr1bnr/pbpq4/2n1pp2/3p3p/3P1P1B/2N2N1Q/PPP3PP/2KR1B1R w",
-			"3rr1k1/pp3pp1/1qn2np1/8/3p4/PP1R1P2/2P1NQPP/R1B3K1 b",
-			"2r1nrk1/p2q1ppp/bp1p4/n1pPp3/P1P1P3/2PBB1N1/4QPPP/R4RK1 w",
-			"r3r1k1/ppqb1ppp/8/4p1NQ/8/2P5/PP3PPP/R3R1K1 b",
-			"r2q1rk1/4bppp/p2p4/2pP4/3pP3/3Q4/PP1B1PPP/R3R1K1 w",
-			"rnb2r1k/pp2p2p/2pp2p1/q2P1p2/8/1Pb2NP1/PB2PPBP/R2Q1RK1 w",
-			"2r3k1/1p2q1pp/2b1pr2/p1pp4/6Q1/1P1PP1R1/P1PN2PP/5RK1 w",
-			"r1bqkb1r/4npp1/p1p4p/1p1pP1B1/8/1B6/PPPN1PPP/R2Q1RK1 w kq",
-			"r2q1rk1/1ppnbppp/p2p1nb1/3Pp3/2P1P1P1/2N2N1P/PPB1QP2/R1B2RK1 b",
-			"r1bq1rk1/pp2ppbp/2np2p1/2n5/P3PP2/N1P2N2/1PB3PP/R1B1QRK1 b",
-			"3rr3/2pq2pk/p2p1pnp/8/2QBPP2/1P6/P5PP/4RRK1 b",
-			"r4k2/pb2bp1r/1p1qp2p/3pNp2/3P1P2/2N3P1/PPP1Q2P/2KRR3 w",
-			"3rn2k/ppb2rpp/2ppqp2/5N2/2P1P3/1P5Q/PB3PPP/3RR1K1 w",
-			"2r2rk1/1bqnbpp1/1p1ppn1p/pP6/N1P1P3/P2B1N1P/1B2QPP1/R2R2K1 b",
-			"r1bqk2r/pp2bppp/2p5/3pP3/P2Q1P2/2N1B3/1PP3PP/R4RK1 b kq",
-			"r2qnrnk/p2b2b1/1p1p2pp/2pPpp2/1PP1P3/PRNBB3/3QNPPP/5RK1 w",
-			"4Q3/6pk/2pq4/3p4/1p1P3p/1P1K1P2/1PP3P1/8 b",
-			"8/5pk1/4p3/7Q/8/3q4/KP6/8 b",
-			"r3bb2/P1q3k1/Q2p3p/2pPp1pP/2B1P3/2B5/6P1/R5K1 w",
-			"r1b5/p2k1r1p/3P2pP/1ppR4/2P2p2/2P5/P1B4P/4R1K1 w",
-			"6r1/1p3k2/pPp4R/K1P1p1p1/1P2Pp1p/5P1P/6P1/8 w",
-			"1k2b3/4bpp1/p2pp1P1/1p3P2/2q1P3/4B3/PPPQN2r/1K1R4 w",
-			"2kr3r/ppp1qpp1/2p5/2b2b2/2P1pPP1/1P2P1p1/PBQPB3/RN2K1R1 b",
-			"6k1/2q3p1/1n2Pp1p/pBp2P2/Pp2P3/1P1Q1KP1/8/8 w",
-			"5r2/pp1RRrk1/4Qq1p/1PP3p1/8/4B3/1b3P1P/6K1 w",
-			"6k1/1q2rpp1/p6p/P7/1PB1n3/5Q2/6PP/5R1K w",
-			"3r2k1/p6p/b2r2p1/2qPQp2/2P2P2/8/6BP/R4R1K w",
-			"8/6Bp/6p1/2k1p3/4PPP1/1pb4P/8/2K5 b",
-			"2r1rbk1/p1Bq1ppp/Ppn1b3/1Npp4/B7/3P2Q1/1PP2PPP/R4RK1 w",
-			"r4rk1/ppq3pp/2p1Pn2/4p1Q1/8/2N5/PP4PP/2KR1R2 w",
-			"6k1/p4pp1/Pp2r3/1QPq3p/8/6P1/2P2P1P/1R4K1 w",
-			"8/2k5/2p5/2pb2K1/pp4P1/1P1R4/P7/8 b",
-			"2r5/1r5k/1P3p2/PR2pP1p/4P2p/2p1BP2/1p2n3/4R2K b",
-			"8/1R2P3/6k1/3B4/2P2P2/1p2r3/1Kb4p/8 w",
-			"1q1r3k/3P1pp1/ppBR1n1p/4Q2P/P4P2/8/5PK1/8 w",
-			"6k1/5pp1/pb1r3p/8/2q1P3/1p3N1P/1P3PP1/2R1Q1K1 b",
-			"8/Bpk5/8/P2K4/8/8/8/8 w",
-			"1r6/5k2/p4p1K/5R2/7P/8/6P1/8 w",
-			"8/6k1/p4p2/P3q2p/7P/5Q2/5PK1/8 w",
-			"8/8/6p1/3Pkp2/4P3/2K5/6P1/n7 w",
-			"1k1r4/pp1b1R2/3q2pp/4p3/2B5/4Q3/PPP2B2/2K5 b",
-			"q1rr1k/3bbnnp/p2p1pp1/2pPp3/PpP1P1P1/1P2BNNP/2BQ1PRK/7R b",
-			"r1b2rk1/2q1b1pp/p2ppn2/1p6/3QP3/1BN1B3/PPP3PP/R4RK1 w",
-			"2r3k1/pppR1pp1/4p3/4P1P1/5P2/1P4K1/P1P5/8 w",
-			"1nk1r1r1/pp2n1pp/4p3/q2pPp1N/b1pP1P2/B1P2R2/2P1B1PP/R2Q2K1 w",
-			"4b3/p3kp2/6p1/3pP2p/2pP1P2/4K1P1/P3N2P/8 w",
-			"2kr1bnr/pbpq4/2n1pp2/3p3p/3P1P1B/2N2N1Q/PPP3PP/2KR1B1R w",
-			"3rr1k1/pp3pp1/1qn2np1/8/3p4/PP1R1P2/2P1NQPP/R1B3K1 b",
-			"2r1nrk1/p2q1ppp/bp1p4/n1pPp3/P1P1P3/2PBB1N1/4QPPP/R4RK1 w",
-			"r3r1k1/ppqb1ppp/8/4p1NQ/8/2P5/PP3PPP/R3R1K1 b",
-			"r2q1rk1/4bppp/p2p4/2pP4/3pP3/3Q4/PP1B1PPP/R3R1K1 w",
-			"rnb2r1k/pp2p2p/2pp2p1/q2P1p2/8/1Pb2NP1/PB2PPBP/R2Q1RK1 w",
-			"2r3k1/1p2q1pp/2b1pr2/p1pp4/6Q1/1P1PP1R1/P1PN2PP/5RK1 w",
-			"r1bqkb1r/4npp1/p1p4p/1p1pP1B1/8/1B6/PPPN1PPP/R2Q1RK1 w kq",
-			"r2q1rk1/1ppnbppp/p2p1nb1/3Pp3/2P1P1P1/2N2N1P/PPB1QP2/R1B2RK1 b",
-			"r1bq1rk1/pp2ppbp/2np2p1/2n5/P3PP2/N1P2N2/1PB3PP/R1B1QRK1 b",
-			"3rr3/2pq2pk/p2p1pnp/8/2QBPP2/1P6/P5PP/4RRK1 b",
-			"r4k2/pb2bp1r/1p1qp2p/3pNp2/3P1P2/2N3P1/PPP1Q2P/2KRR3 w",
-			"3rn2k/ppb2rpp/2ppqp2/5N2/2P1P3/1P5Q/PB3PPP/3RR1K1 w",
-			"2r2rk1/1bqnbpp1/1p1ppn1p/pP6/N1P1P3/P2B1N1P/1B2QPP1/R2R2K1 b",
-			"r1bqk2r/pp2bppp/2p5/3pP3/P2Q1P2/2N1B3/1PP3PP/R4RK1 b kq",
-			"r2qnrnk/p2b2b1/1p1p2pp/2pPpp2/1PP1P3/PRNBB3/3QNPPP/5RK1 w"
-		};
 
 		std::ostringstream output;
 
-		for (auto &&pos : Positions)
+		for (auto &&pos : TestPositions)
 		{
 			Board board;
 			board.setToFen(pos);
@@ -229,8 +250,7 @@ namespace Tests
 			return;
 		}
 
-		MoveList moveList(board);
-		moveList.keepLegalMoves();
+		const MoveList moveList(board);
 
 		for (const Move move : moveList)
 		{
@@ -244,8 +264,7 @@ namespace Tests
 	{
 		PerftInfo info{};
 
-		MoveList moveList(board);
-		moveList.keepLegalMoves();
+		const MoveList moveList(board);
 
 		for (const Move move : moveList)
 		{
@@ -367,4 +386,447 @@ namespace Tests
 	}
 
 	// endregion Perft
+
+	// region Transposition Table
+
+	std::string runTranspositionTableStressTest() noexcept
+	{
+		static constexpr usize KeyCount = 1u << 14u;
+		static constexpr usize Iterations = 1u << 21u;
+		const usize threadCount = std::max(4u, std::thread::hardware_concurrency());
+
+		// A small table, so that the threads keep writing to the same clusters
+		TranspositionTable table{ 1 };
+
+		std::vector<u64> keys(KeyCount);
+		std::mt19937_64 random{ 0x9E3779B97F4A7C15ull };
+		for (auto &&key : keys)
+			key = random();
+
+		// The move, the score and the eval are derived from the key, so an entry of another position can be detected
+		const auto expectedMove = [](const u64 key)
+		{
+			return Move{ u32(key & 0xFFFu), i32(i16(key >> 16u)) };
+		};
+		const auto expectedEval = [](const u64 key)
+		{
+			return i32(i16(key >> 32u));
+		};
+
+		std::atomic_size_t hits{};
+		std::atomic_size_t wrongEntries{};
+		std::vector<std::thread> threads;
+
+		for (usize threadId{}; threadId < threadCount; ++threadId)
+		{
+			threads.emplace_back([&, threadId]
+			{
+				std::mt19937_64 threadRandom{ threadId };
+
+				for (usize i{}; i < Iterations; ++i)
+				{
+					const u64 key = keys[threadRandom() % KeyCount];
+
+					if (i & 1u)
+					{
+						const auto entry = table.probe(key);
+						if (!entry.has_value())
+							continue;
+
+						++hits;
+						const Move move = entry->move();
+						const Move expected = expectedMove(key);
+						if (move.getFromToBits() != expected.getFromToBits() || move.getScore() != expected.getScore()
+							|| entry->eval() != expectedEval(key))
+							++wrongEntries;
+					} else
+					{
+						const auto depth = i32(threadRandom() % MAX_DEPTH);
+						table.insert(key, SearchEntry{ depth, expectedMove(key), false, SearchEntry::Bound::EXACT,
+													   expectedEval(key) });
+					}
+				}
+			});
+		}
+
+		for (auto &&thread : threads)
+			thread.join();
+
+		std::ostringstream output;
+		if (hits == 0)
+			output << "Transposition Table had no hits\n";
+		if (wrongEntries != 0)
+			output << "Transposition Table returned " << wrongEntries << " wrong entries out of "
+				   << hits << " hits\n";
+
+		return output.str();
+	}
+
+	// endregion Transposition Table
+
+	// region Bench
+
+	/**
+	 * Counts the reads of the last level cache in all the threads of the process, which are the reads that missed
+	 * the caches before it. Only available on Linux, when the kernel exposes the hardware counters
+	 */
+	class LlcReadCounter
+	{
+	public:
+		LlcReadCounter() noexcept
+		{
+#ifdef __linux__
+			perf_event_attr attr{};
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.size = sizeof(attr);
+			attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8u)
+						  | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16u);
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+
+			// Counters are only inherited by the threads created after them, so each existing thread gets its own
+			if (DIR *tasks = opendir("/proc/self/task"))
+			{
+				while (const dirent *task = readdir(tasks))
+				{
+					if (task->d_name[0] == '.')
+						continue;
+
+					const auto threadId = pid_t(std::stoi(task->d_name));
+					const int fd = int(syscall(SYS_perf_event_open, &attr, threadId, -1, -1, 0));
+					if (fd != -1)
+						_fds.push_back(fd);
+				}
+				closedir(tasks);
+			}
+#endif
+		}
+
+		LlcReadCounter(const LlcReadCounter &) = delete;
+		LlcReadCounter &operator=(const LlcReadCounter &) = delete;
+
+		~LlcReadCounter()
+		{
+#ifdef __linux__
+			for (const int fd : _fds)
+				close(fd);
+#endif
+		}
+
+		[[nodiscard]] bool isAvailable() const noexcept { return !_fds.empty(); }
+
+		[[nodiscard]] u64 read() const noexcept
+		{
+			u64 total{};
+#ifdef __linux__
+			for (const int fd : _fds)
+			{
+				u64 count{};
+				if (::read(fd, &count, sizeof(count)) == sizeof(count))
+					total += count;
+			}
+#endif
+			return total;
+		}
+
+	private:
+		std::vector<int> _fds;
+	};
+
+#if defined(__linux__) && !defined(__ANDROID__)
+	/**
+	 * Starts this executable again and measures the time until it sends "uciok",
+	 * which includes loading the binary and initializing the engine
+	 * @return the time in microseconds or -1 if the process could not be started
+	 */
+	static i64 measureStartupTimeUs()
+	{
+		int input[2];
+		int output[2];
+		if (pipe(input) != 0)
+			return -1;
+		if (pipe(output) != 0)
+		{
+			close(input[0]);
+			close(input[1]);
+			return -1;
+		}
+
+		posix_spawn_file_actions_t actions;
+		posix_spawn_file_actions_init(&actions);
+		posix_spawn_file_actions_adddup2(&actions, input[0], STDIN_FILENO);
+		posix_spawn_file_actions_adddup2(&actions, output[1], STDOUT_FILENO);
+		posix_spawn_file_actions_addclose(&actions, input[1]);
+		posix_spawn_file_actions_addclose(&actions, output[0]);
+
+		char path[] = "/proc/self/exe";
+		char *arguments[] = { path, nullptr };
+
+		const auto startTime = std::chrono::steady_clock::now();
+		pid_t pid{};
+		const bool spawned = posix_spawn(&pid, path, &actions, nullptr, arguments, environ) == 0;
+
+		posix_spawn_file_actions_destroy(&actions);
+		close(input[0]);
+		close(output[1]);
+
+		i64 timeUs = -1;
+		if (spawned)
+		{
+			std::string received;
+			std::array<char, 4096> buffer{};
+			ssize_t count{};
+
+			while ((count = ::read(output[0], buffer.data(), buffer.size())) > 0)
+			{
+				received.append(buffer.data(), usize(count));
+				if (received.find("uciok") != std::string::npos)
+				{
+					const auto endTime = std::chrono::steady_clock::now();
+					timeUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+					break;
+				}
+			}
+		}
+
+		// Closing its input makes the engine exit
+		close(input[1]);
+		close(output[0]);
+		if (spawned)
+			waitpid(pid, nullptr, 0);
+
+		return timeUs;
+	}
+#endif
+
+	/**
+	 * Searches all the test positions from a clean state and returns the total number of nodes
+	 */
+	static u64 searchBenchPositions(const SearchOptions &options)
+	{
+		// Start from a clean state, so that the number of nodes only depends on the code
+		Search::clearAll();
+
+		u64 totalNodes{};
+		for (usize i{}; i < TestPositions.size(); ++i)
+		{
+			std::cout << "\nPosition " << (i + 1) << '/' << TestPositions.size()
+					  << ": " << TestPositions[i] << std::endl;
+
+			Board board;
+			board.setToFen(TestPositions[i]);
+
+			Search::findBestMove(board, options);
+			totalNodes += Search::getNodesCount();
+		}
+
+		return totalNodes;
+	}
+
+	void runBenchmark(i32 depth, usize hashSizeMb)
+	{
+		static constexpr i32 BenchDepth = 6;
+		static constexpr usize BenchHashSizeMb = 16;
+
+		if (depth <= 0)
+			depth = BenchDepth;
+		if (hashSizeMb == 0)
+			hashSizeMb = BenchHashSizeMb;
+
+		const SearchOptions options{ depth, 1u, hashSizeMb, true };
+
+		// The search thread has to exist before the cache reads counter is created
+		Search::setThreadCount(options.threadCount());
+		const LlcReadCounter llcReadCounter;
+		const u64 startLlcReads = llcReadCounter.read();
+
+		const auto startTime = std::chrono::steady_clock::now();
+
+		const u64 totalNodes = searchBenchPositions(options);
+
+		const auto endTime = std::chrono::steady_clock::now();
+		const auto timeMs = std::max<i64>(
+			1, std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count());
+		const u64 llcReads = llcReadCounter.read() - startLlcReads;
+
+		std::cout << "\n===========================\n"
+				  << "Total time (ms) : " << timeMs << '\n'
+				  << "Nodes searched  : " << totalNodes << '\n'
+				  << "Nodes/second    : " << totalNodes * 1000 / u64(timeMs) << '\n';
+
+		if (llcReadCounter.isAvailable())
+			std::cout << "LLC reads       : " << llcReads << " (" << std::fixed << std::setprecision(2)
+					  << double(llcReads) / double(std::max<u64>(1, totalNodes)) << " per node)" << std::endl;
+		else
+			std::cout << "LLC reads       : unavailable" << std::endl;
+
+#if defined(__linux__) && !defined(__ANDROID__)
+		static constexpr usize StartupRuns = 10;
+
+		// The fastest run is the one least disturbed by the rest of the system
+		i64 bestStartupUs = -1;
+		for (usize i{}; i < StartupRuns; ++i)
+		{
+			const i64 startupUs = measureStartupTimeUs();
+			if (startupUs != -1 && (bestStartupUs == -1 || startupUs < bestStartupUs))
+				bestStartupUs = startupUs;
+		}
+
+		if (bestStartupUs != -1)
+			std::cout << "Startup (ms)    : " << std::fixed << std::setprecision(2) << double(bestStartupUs) / 1000.0
+					  << " (exec to uciok, best of " << StartupRuns << ')' << std::endl;
+#endif
+	}
+
+	std::string runBenchmarkRepeatTest()
+	{
+		const SearchOptions options{ 5, 1u, 16, true };
+		const u64 firstNodes = searchBenchPositions(options);
+
+		// Also move the table to another age, which the clear has to undo
+		Board board;
+		board.setToStartPos();
+		Search::findBestMove(board, SearchOptions{ 2, 1u, 16, true });
+
+		const u64 secondNodes = searchBenchPositions(options);
+
+		std::ostringstream output;
+		if (firstNodes != secondNodes)
+			output << "Bench searched " << firstNodes << " nodes the first time and " << secondNodes
+				   << " nodes the second time\n";
+
+		return output.str();
+	}
+
+	/**
+	 * The moves of a game played by the engine against itself from the starting position
+	 */
+	static constexpr std::string_view BenchGame =
+		"g1f3 g8f6 d2d3 d7d6 c2c4 c7c5 b1c3 b8c6 a2a3 h7h6 g2g3 c8e6 c1e3 g7g6 h2h3 f8g7 "
+		"f1g2 f6d7 f3d2 a7a6 f2f4 f7f5 d2f3 h8f8 h1g1 e6f7 e3d2 d7f6 a1b1 e7e5 f4e5 d6e5 "
+		"d2e3 d8d6 g3g4 e5e4 d3e4 d6d1 b1d1 f6e4 c3e4 f5e4 f3d2 e8c8 g2e4 g7b2 g1f1 b2d4 "
+		"e3d4 c6d4 f1f6 d8e8 e2e3 d4b3 d1b1 b3a5 b1b6 c8c7 b6b2 c7d8";
+
+	void runGameBenchmark(i32 depth, usize hashSizeMb)
+	{
+		static constexpr i32 GameBenchDepth = 8;
+		static constexpr usize BenchHashSizeMb = 16;
+
+		if (depth <= 0)
+			depth = GameBenchDepth;
+		if (hashSizeMb == 0)
+			hashSizeMb = BenchHashSizeMb;
+
+		// Only the first search starts from a clean state, like in a real game
+		Search::clearAll();
+
+		const SearchOptions options{ depth, 1u, hashSizeMb, true };
+		Board board;
+		board.setToStartPos();
+
+		std::istringstream moves{ std::string{ BenchGame } };
+		std::string token;
+		u64 totalNodes{};
+		i64 totalTimeMs{};
+		usize positionCount{};
+
+		while (true)
+		{
+			const auto startTime = std::chrono::steady_clock::now();
+			Search::findBestMove(board, options);
+			const auto endTime = std::chrono::steady_clock::now();
+
+			totalTimeMs += std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+			totalNodes += Search::getNodesCount();
+			++positionCount;
+
+			if (!(moves >> token))
+				break;
+
+			const Move move = parseMove(board, token);
+			if (move.empty())
+			{
+				std::cout << "Illegal move in the benchmark game: " << token << std::endl;
+				return;
+			}
+			board.makeMove(move);
+		}
+
+		totalTimeMs = std::max<i64>(1, totalTimeMs);
+
+		std::cout << "\n===========================\n"
+				  << "Positions       : " << positionCount << '\n'
+				  << "Total time (ms) : " << totalTimeMs << '\n'
+				  << "Nodes searched  : " << totalNodes << '\n'
+				  << "Nodes/second    : " << totalNodes * 1000 / u64(totalTimeMs) << std::endl;
+	}
+
+	void runAttacksBenchmark()
+	{
+		static constexpr usize LookupCount = 1u << 16u;
+		static constexpr usize LookupRounds = 256;
+		static constexpr std::array<std::pair<std::string_view, unsigned>, 2> PerftPositions = { {
+			{ TestPositions[0], 5 },
+			{ TestPositions[1], 4 },
+		} };
+
+		// Three random numbers and'ed together leave about as many blockers as in a middle game
+		std::vector<std::pair<Square, Bitboard>> lookups(LookupCount);
+		std::mt19937_64 random{ 0x9E3779B97F4A7C15ull };
+		for (auto &&[square, blockers] : lookups)
+		{
+			square = toSquare(u8(random() % SQUARE_NB));
+			blockers = Bitboard{ random() & random() & random() };
+		}
+
+		const auto initialBackend = Attacks::getSliderBackend();
+		std::vector<Attacks::SliderBackend> backends{ Attacks::SliderBackend::MAGICS };
+		if (Attacks::isPextSupported())
+			backends.push_back(Attacks::SliderBackend::PEXT);
+
+		for (const auto backend : backends)
+		{
+			Attacks::setSliderBackend(backend);
+			std::cout << '\n' << (backend == Attacks::SliderBackend::PEXT ? "PEXT" : "Magics") << ":\n";
+
+			// The checksum keeps the lookups from being optimized away and must be the same for every backend
+			u64 checksum{};
+			auto startTime = std::chrono::steady_clock::now();
+
+			for (usize round{}; round < LookupRounds; ++round)
+				for (const auto &[square, blockers] : lookups)
+					checksum += Attacks::queenAttacks(square, blockers).value();
+
+			auto endTime = std::chrono::steady_clock::now();
+			const auto lookupTimeNs = std::max<i64>(
+				1, std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count());
+
+			std::cout << "Queen lookups/second : " << LookupCount * LookupRounds * 1000'000'000u / u64(lookupTimeNs)
+					  << " (checksum " << std::hex << checksum << std::dec << ")\n";
+
+			u64 perftNodes{};
+			startTime = std::chrono::steady_clock::now();
+
+			for (const auto &[fen, depth] : PerftPositions)
+			{
+				Board board;
+				board.setToFen(std::string{ fen });
+
+				PerftInfo info{};
+				perft(board, info, depth);
+				perftNodes += info.nodes;
+			}
+
+			endTime = std::chrono::steady_clock::now();
+			const auto perftTimeMs = std::max<i64>(
+				1, std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count());
+
+			std::cout << "Perft nodes          : " << perftNodes << '\n'
+					  << "Perft nodes/second   : " << perftNodes * 1000 / u64(perftTimeMs) << std::endl;
+		}
+
+		Attacks::setSliderBackend(initialBackend);
+	}
+
+	// endregion Bench
 }
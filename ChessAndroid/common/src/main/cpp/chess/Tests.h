@@ -11,4 +11,35 @@ namespace Tests
 	void runPerftTests() noexcept;
 
 	void runPerftForPosition(const std::string &fen, i32 depth);
+
+	/**
+	 * Multiple threads insert and probe the same clusters of a small table at the same time,
+	 * checking that no entry is ever returned for the wrong position
+	 */
+	std::string runTranspositionTableStressTest() noexcept;
+
+	/**
+	 * Searches a fixed set of positions with a single thread, the total number of nodes
+	 * is a signature of the search, which only changes when the search behaviour does.
+	 * The last level cache reads of the search and the time from starting the engine to "uciok" are reported when available.
+	 * Defaults to depth 6 and a 16MB hash table if they are 0
+	 */
+	void runBenchmark(i32 depth, usize hashSizeMb);
+
+	/**
+	 * Runs a short bench twice in the same process, the node count must not depend on the searches before it
+	 */
+	std::string runBenchmarkRepeatTest();
+
+	/**
+	 * Searches every position of a fixed game to the same depth, without clearing the state between moves,
+	 * which measures the time to depth when the searches of the previous moves can be reused.
+	 * Defaults to depth 8 and a 16MB hash table if they are 0
+	 */
+	void runGameBenchmark(i32 depth, usize hashSizeMb);
+
+	/**
+	 * Times the sliding attack lookups and the perft speed with every backend this CPU supports
+	 */
+	void runAttacksBenchmark();
 }
@@ -1,6 +1,38 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <vector>
+
+#include "Defs.h"
+#include "Move.h"
+#include "DirectMappedCache.h"
+#include "TranspositionTable.h"
+
+struct RootMove
+{
+	using PvLine = std::array<Move, MAX_DEPTH + 1>;
+
+	Move move;
+	int score{ VALUE_MIN };
+	/**
+	 * Nodes searched below this move during the last iteration, used for ordering the next one
+	 */
+	u64 nodes{};
+	PvLine pv{};
+	u8 pvLength{};
+
+	explicit RootMove(const Move rootMove) noexcept
+		: move(rootMove)
+	{
+		pv[0] = rootMove;
+		pvLength = 1;
+	}
+
+	bool operator==(const Move &rhs) const noexcept { return move == rhs; }
+};
+
+using RootMoves = std::vector<RootMove>;
 
 class Thread
 {
@@ -8,14 +40,44 @@ public:
 	using Killers = std::array<std::array<u32, MAX_DEPTH>, COLOR_NB>;
 	using History = std::array<std::array<u16, SQUARE_NB>, SQUARE_NB>;
 	using EvalStack = std::array<i32, MAX_DEPTH>;
+	using PvLine = RootMove::PvLine;
 
 	const usize threadId;
 	const bool mainThread;
 	Killers killers{};
 	History history{};
 	EvalStack evalStack{};
+	/**
+	 * Results of the quiescence search, which are far more numerous than the ones of the main search.
+	 * They are kept out of the Transposition Table, where they would evict deeper entries
+	 * and be written to memory shared with the other threads
+	 */
+	DirectMappedCache<SearchEntry> qSearchCache{ QSEARCH_CACHE_SIZE_KB };
+	/**
+	 * Static evaluations of the positions recently evaluated by this thread,
+	 * so that the transpositions missing from the Transposition Table are not evaluated again
+	 */
+	DirectMappedCache<i32> evalCache{ EVAL_CACHE_SIZE_KB };
+
+	/**
+	 * Triangular PV table: the line at index ply holds the principal variation
+	 * found from that ply onwards, starting at pvTable[ply][ply]
+	 */
+	std::array<PvLine, MAX_DEPTH + 1> pvTable{};
+	std::array<u8, MAX_DEPTH + 1> pvLength{};
+
+	RootMoves rootMoves{};
+	/**
+	 * Index of the root move whose MultiPV line is currently being searched
+	 */
+	usize pvIndex{};
 
-	usize nodesCount{};
+	/**
+	 * Nodes searched by this thread during the current search,
+	 * only the ones past reportedNodes have been added to the shared nodes counter
+	 */
+	u64 nodesCount{};
+	u64 reportedNodes{};
 
 	Thread(const std::size_t threadId, const bool mainThread)
 		: threadId(threadId), mainThread(mainThread) {}
@@ -25,5 +87,60 @@ public:
 		killers.fill({});
 		history.fill({});
 		evalStack.fill({});
+		pvLength.fill({});
+		qSearchCache.clear();
+		evalCache.clear();
 	}
+
+	/**
+	 * Keeps the move ordering tables warm between searches of the same game:
+	 * the history is scaled down so that newer cutoffs quickly take over and
+	 * the killers are shifted by two plies, as the root advanced by a full move
+	 */
+	void ageTables() noexcept
+	{
+		for (auto &&from : history)
+			for (auto &&value : from)
+				value /= HISTORY_AGE_DIVISOR;
+
+		for (auto &&plyKillers : killers)
+		{
+			std::copy(plyKillers.begin() + 2, plyKillers.end(), plyKillers.begin());
+			std::fill(plyKillers.end() - 2, plyKillers.end(), 0u);
+		}
+
+		evalStack.fill({});
+	}
+
+	void clearPv(const int ply) noexcept
+	{
+		pvLength[ply] = u8(ply);
+	}
+
+	/**
+	 * Makes the move the start of the principal variation at this ply,
+	 * followed by the line of the child node it was searched in
+	 */
+	void updatePv(const int ply, const Move move) noexcept
+	{
+		auto &&line = pvTable[ply];
+		const auto &childLine = pvTable[ply + 1];
+		const u8 childLength = pvLength[ply + 1];
+
+		line[ply] = move;
+		std::copy(childLine.begin() + ply + 1, childLine.begin() + childLength, line.begin() + ply + 1);
+		pvLength[ply] = childLength;
+	}
+
+	void addHistory(const Square from, const Square to, const int bonus) noexcept
+	{
+		auto &value = history[from][to];
+		value = u16(std::min<int>(value + bonus, HISTORY_MAX));
+	}
+
+private:
+	static constexpr usize QSEARCH_CACHE_SIZE_KB = 256;
+	static constexpr usize EVAL_CACHE_SIZE_KB = 256;
+	static constexpr u16 HISTORY_AGE_DIVISOR = 2;
+	static constexpr int HISTORY_MAX = UINT16_MAX;
 };
@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+
+ThreadPool::Worker::Worker(const usize threadId, const Job &job)
+	: _thread(threadId, threadId == 1), _job(job), _nativeThread(&Worker::idleLoop, this)
+{
+	// Wait for the thread to reach the idle loop
+	wait();
+}
+
+ThreadPool::Worker::~Worker()
+{
+	assert(!isSearching());
+
+	{
+		std::lock_guard lock{ _mutex };
+		_exit = true;
+		_searching = true;
+	}
+	_condition.notify_one();
+
+	_nativeThread.join();
+}
+
+void ThreadPool::Worker::start()
+{
+	{
+		std::lock_guard lock{ _mutex };
+		_searching = true;
+	}
+	_condition.notify_one();
+}
+
+void ThreadPool::Worker::wait()
+{
+	std::unique_lock lock{ _mutex };
+	_condition.wait(lock, [this] { return !_searching; });
+}
+
+bool ThreadPool::Worker::isSearching()
+{
+	std::lock_guard lock{ _mutex };
+	return _searching;
+}
+
+void ThreadPool::Worker::idleLoop()
+{
+	while (true)
+	{
+		std::unique_lock lock{ _mutex };
+		_searching = false;
+		_condition.notify_one(); // Wake up anyone waiting for the search to finish
+		_condition.wait(lock, [this] { return _searching; });
+
+		if (_exit)
+			return;
+
+		lock.unlock();
+
+		_job(_thread);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	wait();
+	resize(0);
+}
+
+void ThreadPool::resize(const usize threadCount)
+{
+	assert(!isSearching());
+
+	// Only the extra workers are destroyed or created, the others keep their Thread data
+	while (_workers.size() > threadCount)
+		_workers.pop_back();
+
+	while (_workers.size() < threadCount)
+		_workers.push_back(std::make_unique<Worker>(_workers.size() + 1, _job));
+}
+
+void ThreadPool::start(const Job &job)
+{
+	assert(!isSearching());
+
+	_job = job;
+
+	for (auto &&worker : _workers)
+		worker->start();
+}
+
+void ThreadPool::wait()
+{
+	for (auto &&worker : _workers)
+		worker->wait();
+}
+
+bool ThreadPool::isSearching()
+{
+	for (auto &&worker : _workers)
+		if (worker->isSearching())
+			return true;
+
+	return false;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Thread.h"
+
+/**
+ * Long lived search workers, each one owns its Thread data and is parked on a condition variable
+ * between searches, so no threads are created or destroyed when a search is started
+ */
+class ThreadPool final
+{
+public:
+	using Job = std::function<void(Thread &)>;
+
+private:
+	class Worker final
+	{
+	public:
+		Worker(usize threadId, const Job &job);
+
+		Worker(const Worker &) = delete;
+		Worker(Worker &&) = delete;
+		~Worker();
+
+		Worker &operator=(const Worker &) = delete;
+		Worker &operator=(Worker &&) = delete;
+
+		void start();
+		void wait();
+		[[nodiscard]] bool isSearching();
+
+		Thread &thread() noexcept { return _thread; }
+
+	private:
+		void idleLoop();
+
+		Thread _thread;
+		const Job &_job;
+
+		std::mutex _mutex{};
+		std::condition_variable _condition{};
+		bool _searching{ true };
+		bool _exit{};
+
+		// Must be the last member, as it starts running as soon as it is constructed
+		std::thread _nativeThread;
+	};
+
+public:
+	ThreadPool() = default;
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	~ThreadPool();
+
+	ThreadPool &operator=(const ThreadPool &) = delete;
+	ThreadPool &operator=(ThreadPool &&) = delete;
+
+	/**
+	 * Must not be called while a search is running
+	 */
+	void resize(usize threadCount);
+	[[nodiscard]] usize size() const noexcept { return _workers.size(); }
+
+	/**
+	 * Wakes all the workers, each one will run the job with its own Thread data
+	 */
+	void start(const Job &job);
+	void wait();
+	[[nodiscard]] bool isSearching();
+
+	template <class Func>
+	void forEach(Func &&func)
+	{
+		for (auto &&worker : _workers)
+			func(worker->thread());
+	}
+
+private:
+	Job _job{};
+	std::vector<std::unique_ptr<Worker>> _workers{};
+};
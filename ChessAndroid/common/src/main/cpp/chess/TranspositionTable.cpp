@@ -1,13 +1,69 @@
 #include "TranspositionTable.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <vector>
 
 #ifdef _MSC_VER
 #	include <xmmintrin.h>
 #endif
 
+#ifdef __linux__
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#	ifndef __ANDROID__
+#		include <sys/file.h>
+#	endif
+#endif
+
 static constexpr u64 MB = 1ull << 20;
+static constexpr usize HUGE_PAGE_SIZE = 2 * MB;
+
+static constexpr usize roundUp(const usize value, const usize multiple) noexcept
+{
+	return (value + multiple - 1) / multiple * multiple;
+}
+
+/**
+ * The high half of the 128-bit product, maps a key uniformly to [0, size) without requiring a power of two size
+ */
+static u64 mulHigh64(const u64 a, const u64 b) noexcept
+{
+#ifdef __SIZEOF_INT128__
+	__extension__ using u128 = unsigned __int128;
+	return u64((u128(a) * u128(b)) >> 64u);
+#else
+	const u64 aLow = u32(a), aHigh = a >> 32u;
+	const u64 bLow = u32(b), bHigh = b >> 32u;
+	const u64 lowLow = aLow * bLow;
+	const u64 middle1 = aHigh * bLow + (lowLow >> 32u);
+	const u64 middle2 = aLow * bHigh + u32(middle1);
+	return aHigh * bHigh + (middle1 >> 32u) + (middle2 >> 32u);
+#endif
+}
+
+#ifdef __linux__
+/**
+ * madvise(MADV_HUGEPAGE) also succeeds when transparent huge pages are turned off,
+ * they are only used if the selected mode is "always" or "madvise"
+ */
+static bool areTransparentHugePagesEnabled() noexcept
+{
+	std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+	std::string mode;
+	std::getline(file, mode);
+
+	return mode.find("[always]") != std::string::npos || mode.find("[madvise]") != std::string::npos;
+}
+#endif
 
 TranspositionTable::TranspositionTable(const usize sizeMb)
 {
@@ -16,14 +72,14 @@ TranspositionTable::TranspositionTable(const usize sizeMb)
 
 TranspositionTable::~TranspositionTable()
 {
-	delete[] _clusters;
+	deallocate();
 }
 
 void TranspositionTable::prefetch(const u64 zKey) const noexcept
 {
 	assert(_clusters);
 
-	const auto address = &_clusters[(zKey >> 48u) & _hashMask];
+	const auto address = &getCluster(zKey);
 #ifdef _MSC_VER
 	_mm_prefetch(reinterpret_cast<char*>(address), _MM_HINT_T0);
 #else
@@ -35,17 +91,14 @@ std::optional<SearchEntry> TranspositionTable::probe(const u64 zKey) const noexc
 {
 	assert(_clusters);
 
-	const u16 key16 = zKey >> 48u;
-	const auto index = zKey & _hashMask;
+	const auto &slots = getCluster(zKey).slots;
 
-	assert(index < _size);
-	auto &clusterEntries = _clusters[index].entries;
-
-	for (usize i = 0; i < CLUSTER_SIZE; ++i)
+	for (auto &&slot : slots)
 	{
-		auto &entry = clusterEntries[i];
-		if (key16 == entry.key() && currentAge() == entry.age())
-			return entry;
+		// Entries from previous searches are still valid, their age only matters for the replacement
+		const u64 data = slot.data();
+		if (slot.key(data) == zKey)
+			return Slot::toEntry(data);
 	}
 
 	return {};
@@ -55,78 +108,88 @@ void TranspositionTable::insert(const u64 zKey, SearchEntry entry) noexcept
 {
 	assert(_clusters);
 
-	const auto key = entry.key();
-	const auto index = zKey & _hashMask;
 	const auto tableAge = currentAge();
+	auto &slots = getCluster(zKey).slots;
 
-	assert(index < _size);
-	auto &clusterEntries = _clusters[index].entries;
-	auto *toReplace = &clusterEntries.front();
-
+	// Each slot is only read once, as other threads may be writing to it at the same time
+	std::array<SearchEntry, CLUSTER_SIZE> entries;
+	usize toReplace{};
 	usize i{};
-	for (; i < CLUSTER_SIZE && key != clusterEntries[i].key(); ++i)
+
+	for (; i < CLUSTER_SIZE; ++i)
 	{
-		if (toReplace->depth() - (tableAge - toReplace->age())
-			>= clusterEntries[i].depth() - (tableAge - clusterEntries[i].age()))
-			toReplace = &clusterEntries[i];
+		const u64 data = slots[i].data();
+		entries[i] = Slot::toEntry(data);
+
+		if (slots[i].key(data) == zKey)
+			break;
+
+		if (entries[toReplace].depth() - ageDistance(entries[toReplace].age())
+			>= entries[i].depth() - ageDistance(entries[i].age()))
+			toReplace = i;
 	}
 
-	toReplace = (i != CLUSTER_SIZE) ? &clusterEntries[i] : toReplace;
+	// Don't overwrite an entry of this search from the same position, unless
+	// we have an exact bound or depth that is nearly as good as the old one
+	if (i != CLUSTER_SIZE)
+	{
+		if (entry.bound() != SearchEntry::Bound::EXACT
+			&& entry.depth() < entries[i].depth() - 3
+			&& ageDistance(entries[i].age()) == 0)
+			return;
 
-	// Don't overwrite an entry from the same position, unless we have
-	// an exact bound or depth that is nearly as good as the old one
-	if (key == toReplace->key()
-		&& entry.bound() != SearchEntry::Bound::EXACT
-		&& entry.depth() < toReplace->depth() - 3)
-		return;
+		toReplace = i;
+	}
 
 	entry.setAge(tableAge);
-	*toReplace = entry;
+	slots[toReplace].store(zKey, Slot::toData(entry));
 }
 
 bool TranspositionTable::setSize(usize sizeMb)
 {
-	const auto newSize = (sizeMb << 20u) / sizeof(Cluster);
+	const auto newSize = usize(sizeMb * MB / sizeof(Cluster));
 
-	if (newSize == 0 || _size == newSize) return false;
+	// The size of a shared table was decided by the process that created it
+	if (newSize == 0 || _size == newSize || isShared()) return false;
 
 	_size = newSize;
-	delete[] _clusters;
-	_clusters = nullptr;
+	deallocate();
 
 	while (!_clusters && sizeMb)
 	{
-		const auto bytesSize = sizeof(Cluster) * _size;
-		_clusters = static_cast<Cluster *>(operator new[](bytesSize, std::nothrow));
-
-		if (_clusters)
-			clear();
-		else
+		if (allocate(sizeof(Cluster) * _size))
+		{
+			// Fresh mappings are made of zeroed pages, which are only touched once they are used
+			if (_mappedBytes == 0)
+				clear();
+			else
+				_zeroed = true;
+		} else
 		{
 			std::cerr << "Failed to allocate " << sizeMb << "MB for the Transposition Table\n";
 			sizeMb /= 2;
-			_size = (sizeMb << 20u) / sizeof(Cluster);
+			_size = usize(sizeMb * MB / sizeof(Cluster));
 		}
 	}
 
-	u64 keySize = 16u;
-	while ((1ull << keySize) * sizeof(Cluster) <= sizeMb * MB / 2)
-		++keySize;
-
-	_hashMask = (1ull << keySize) - 1u;
-
 	return true;
 }
 
 void TranspositionTable::update() noexcept
 {
-	if (_currentAge == SearchEntry::AGE_MASK)
+	// The age is only compared by its distance from the current one, so it is free to wrap around
+	if (_sharedHeader)
 	{
-		clear();
+		// Another engine may be moving to the next age at the same time
+		u8 age = __atomic_load_n(&_sharedHeader->currentAge, __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(&_sharedHeader->currentAge, &age, u8((age + 1) & SearchEntry::AGE_MASK),
+											true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		{
+		}
+		_currentAge = u8((age + 1) & SearchEntry::AGE_MASK);
 	} else
-	{
 		(++_currentAge) &= SearchEntry::AGE_MASK;
-	}
+	_zeroed = false;
 }
 
 u8 TranspositionTable::currentAge() const noexcept
@@ -134,8 +197,425 @@ u8 TranspositionTable::currentAge() const noexcept
 	return _currentAge;
 }
 
-void TranspositionTable::clear() noexcept
+int TranspositionTable::hashfull() const noexcept
 {
-	std::memset(_clusters, 0, sizeof(Cluster) * _size);
-	_currentAge = {};
+	if (!_clusters)
+		return 0;
+
+	const usize clusterCount = std::min(_size, HASHFULL_SAMPLE_SLOTS / CLUSTER_SIZE);
+	usize used{};
+
+	for (usize i{}; i < clusterCount; ++i)
+	{
+		for (auto &&slot : _clusters[i].slots)
+		{
+			// Empty slots have no bound
+			const auto entry = Slot::toEntry(slot.data());
+			used += entry.bound() != SearchEntry::Bound::NONE && entry.age() == currentAge();
+		}
+	}
+
+	return int(used * 1000 / (clusterCount * CLUSTER_SIZE));
+}
+
+std::string TranspositionTable::formatHistogram() const
+{
+	std::ostringstream stream;
+	if (!_clusters)
+		return stream.str();
+
+	std::map<i32, usize> depths;
+	std::array<usize, SearchEntry::AGE_MASK + 1> ages{};
+	std::array<usize, 4> bounds{};
+	usize qSearchCount{};
+
+	for (usize i{}; i < _size; ++i)
+	{
+		for (auto &&slot : _clusters[i].slots)
+		{
+			const auto entry = Slot::toEntry(slot.data());
+			++bounds[usize(entry.bound())];
+			if (entry.bound() == SearchEntry::Bound::NONE)
+				continue;
+
+			++depths[entry.depth()];
+			++ages[ageDistance(entry.age())];
+			qSearchCount += entry.qSearch();
+		}
+	}
+
+	const usize slotCount = _size * CLUSTER_SIZE;
+	const usize usedCount = slotCount - bounds[usize(SearchEntry::Bound::NONE)];
+
+	stream << "Hash table: " << sizeMb() << "MB, " << slotCount << " slots, "
+		   << usedCount << " used (" << usedCount * 1000 / slotCount << " permille)\n";
+
+	stream << "Bound: exact " << bounds[usize(SearchEntry::Bound::EXACT)]
+		   << " alpha " << bounds[usize(SearchEntry::Bound::ALPHA)]
+		   << " beta " << bounds[usize(SearchEntry::Bound::BETA)]
+		   << ", qsearch " << qSearchCount << '\n';
+
+	stream << "Searches ago:";
+	for (usize age{}; age < ages.size(); ++age)
+		if (ages[age] != 0)
+			stream << ' ' << age << ':' << ages[age];
+
+	stream << "\nDepth:";
+	for (const auto &[depth, count] : depths)
+		stream << ' ' << depth << ':' << count;
+	stream << '\n';
+
+	return stream.str();
+}
+
+bool TranspositionTable::save(const std::string &path, const u64 keySignature) const
+{
+	if (!_clusters)
+		return false;
+
+	const FileHeader header = makeHeader(_size, keySignature);
+
+	std::vector<char> headerBlock(FILE_HEADER_SIZE);
+	std::memcpy(headerBlock.data(), &header, sizeof(FileHeader));
+
+	// The table may be a mapping of the same file, which must not be truncated while it is being written.
+	// Replacing the file only once it is complete also never leaves a partial table behind
+	const std::string tempPath = path + ".tmp";
+	std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+	file.write(headerBlock.data(), std::streamsize(headerBlock.size()));
+	file.write(reinterpret_cast<const char *>(_clusters), std::streamsize(sizeof(Cluster) * _size));
+	file.close();
+
+	if (!file || std::rename(tempPath.c_str(), path.c_str()) != 0)
+	{
+		std::cerr << "Failed to write the Transposition Table to " << path << '\n';
+		std::remove(tempPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool TranspositionTable::load(const std::string &path, const u64 keySignature)
+{
+	std::ifstream file{ path, std::ios::binary | std::ios::ate };
+	if (!file)
+	{
+		std::cerr << "Failed to open " << path << '\n';
+		return false;
+	}
+
+	const auto fileSize = usize(file.tellg());
+	FileHeader header{};
+	file.seekg(0);
+	file.read(reinterpret_cast<char *>(&header), sizeof(FileHeader));
+
+	const char *error = file ? checkHeader(header, keySignature, fileSize) : "it is not a Transposition Table";
+	if (error)
+	{
+		std::cerr << "Failed to load " << path << ": " << error << '\n';
+		return false;
+	}
+
+	const usize bytes = sizeof(Cluster) * header.clusterCount;
+
+	bool mapped = false;
+#ifdef __linux__
+	const int fd = open(path.c_str(), O_RDONLY);
+	void *memory = fd == -1 ? MAP_FAILED
+							: mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, FILE_HEADER_SIZE);
+	if (fd != -1)
+		close(fd);
+
+	if (memory != MAP_FAILED)
+	{
+		deallocate();
+		_clusters = static_cast<Cluster *>(memory);
+		_mappedBytes = bytes;
+		_pageSize = usize(sysconf(_SC_PAGESIZE));
+		_pageType = PageType::NORMAL;
+		_fileBacked = true;
+		mapped = true;
+	}
+#endif
+
+	// Some file systems can not be mapped, so read the whole table instead
+	if (!mapped)
+	{
+		const usize previousSizeMb = sizeMb();
+		deallocate();
+		_size = 0;
+
+		if (allocate(bytes))
+		{
+			file.seekg(std::streamoff(FILE_HEADER_SIZE));
+			file.read(reinterpret_cast<char *>(_clusters), std::streamsize(bytes));
+		}
+
+		// Go back to an empty table of the previous size
+		if (!_clusters || !file)
+		{
+			std::cerr << "Failed to read " << path << '\n';
+			deallocate();
+			setSize(previousSizeMb);
+			return false;
+		}
+	}
+
+	_size = header.clusterCount;
+	_currentAge = header.currentAge;
+	_zeroed = false;
+	return true;
+}
+
+bool TranspositionTable::setShared(const std::string &name, const usize sizeMb, const u64 keySignature)
+{
+	if (name.empty())
+	{
+		if (isShared())
+		{
+			deallocate();
+			_size = 0;
+			setSize(sizeMb);
+		}
+		return true;
+	}
+
+#if defined(__linux__) && !defined(__ANDROID__)
+	const std::string segmentName = name.front() == '/' ? name : '/' + name;
+	const int fd = shm_open(segmentName.c_str(), O_RDWR | O_CREAT, 0600);
+	if (fd == -1)
+	{
+		std::cerr << "Failed to open the shared memory segment " << segmentName << '\n';
+		return false;
+	}
+
+	// Engines that start at the same time must not both create the header
+	flock(fd, LOCK_EX);
+
+	struct stat status{};
+	fstat(fd, &status);
+	const bool created = status.st_size == 0;
+
+	FileHeader header = makeHeader(usize(sizeMb * MB / sizeof(Cluster)), keySignature);
+	const char *error = nullptr;
+
+	if (created)
+	{
+		if (header.clusterCount == 0
+			|| ftruncate(fd, off_t(FILE_HEADER_SIZE + header.clusterCount * sizeof(Cluster))) != 0)
+			error = "it could not be resized";
+	} else if (pread(fd, &header, sizeof(FileHeader), 0) != sizeof(FileHeader))
+		error = "it could not be read";
+	else
+		error = checkHeader(header, keySignature, usize(status.st_size));
+
+	const usize bytes = sizeof(Cluster) * header.clusterCount;
+	void *memory = MAP_FAILED;
+	if (!error)
+	{
+		memory = mmap(nullptr, FILE_HEADER_SIZE + bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (memory == MAP_FAILED)
+			error = "it could not be mapped";
+		else if (created)
+			std::memcpy(memory, &header, sizeof(FileHeader));
+	}
+
+	flock(fd, LOCK_UN);
+	close(fd);
+
+	// The current table is kept if the segment can not be used
+	if (error)
+	{
+		std::cerr << "Failed to use the shared memory segment " << segmentName << ": " << error << '\n';
+		return false;
+	}
+
+	deallocate();
+	_clusters = reinterpret_cast<Cluster *>(static_cast<u8 *>(memory) + FILE_HEADER_SIZE);
+	_sharedHeader = static_cast<FileHeader *>(memory);
+	_size = header.clusterCount;
+	_currentAge = header.currentAge;
+	_mappedBytes = bytes;
+	_pageSize = usize(sysconf(_SC_PAGESIZE));
+	_pageType = PageType::NORMAL;
+	_sharedName = segmentName;
+	return true;
+#else
+	std::cerr << "Shared memory Transposition Tables are not supported on this platform\n";
+	return false;
+#endif
+}
+
+TranspositionTable::FileHeader TranspositionTable::makeHeader(const usize clusterCount,
+															  const u64 keySignature) const noexcept
+{
+	FileHeader header{};
+	header.magic = FILE_MAGIC;
+	header.version = FILE_VERSION;
+	header.clusterBytes = u32(sizeof(Cluster));
+	header.clusterCount = clusterCount;
+	header.keySignature = keySignature;
+	header.ageMask = u8(SearchEntry::AGE_MASK);
+	header.currentAge = _currentAge;
+	return header;
+}
+
+const char *TranspositionTable::checkHeader(const FileHeader &header, const u64 keySignature,
+											const usize totalBytes) noexcept
+{
+	if (header.magic != FILE_MAGIC)
+		return "it is not a Transposition Table";
+	if (header.version != FILE_VERSION || header.clusterBytes != sizeof(Cluster)
+		|| header.ageMask != SearchEntry::AGE_MASK || header.currentAge > SearchEntry::AGE_MASK)
+		return "it has a different table layout";
+	if (header.keySignature != keySignature)
+		return "it uses different position keys";
+	if (header.clusterCount == 0 || totalBytes != FILE_HEADER_SIZE + header.clusterCount * sizeof(Cluster))
+		return "its size does not match its header";
+	return nullptr;
+}
+
+u8 TranspositionTable::ageDistance(const u8 age) const noexcept
+{
+	return u8((_currentAge - age) & SearchEntry::AGE_MASK);
+}
+
+void TranspositionTable::clear(const usize partIndex, const usize partCount) noexcept
+{
+	assert(partIndex < partCount);
+
+	// A shared table is never cleared, as the other engines are still using it
+	if (isShared())
+		return;
+
+	// Empty slots have the first age, so the search after a clear has to start from it again
+	if (partIndex == 0)
+		_currentAge = {};
+
+	// Nothing has been stored since, this also avoids faulting in all the pages of a fresh mapping
+	if (_zeroed)
+		return;
+
+	// Parts are made of whole pages when the table is mapped, so that they can be released
+	const bool mapped = _mappedBytes != 0 && _pageSize != 0;
+	const usize unitSize = mapped ? _pageSize : sizeof(Cluster);
+	const usize units = mapped ? _mappedBytes / _pageSize : _size;
+
+	auto *const memory = reinterpret_cast<u8 *>(_clusters);
+	const usize begin = units * partIndex / partCount * unitSize;
+	const usize end = units * (partIndex + 1) / partCount * unitSize;
+
+#ifdef __linux__
+	// Released pages of a private mapping are replaced with zeroed ones only once they are touched again,
+	// which is a lot faster than writing all of them. Explicit huge pages may not support it, on older kernels
+	if (mapped && !_fileBacked && _pageType != PageType::HUGE
+		&& madvise(memory + begin, end - begin, MADV_DONTNEED) == 0)
+	{
+		if (partCount == 1)
+			_zeroed = true;
+		return;
+	}
+#endif
+
+	const usize tableBytes = sizeof(Cluster) * _size;
+	if (begin < tableBytes)
+		std::memset(memory + begin, 0, std::min(end, tableBytes) - begin);
+	if (partCount == 1)
+		_zeroed = true;
+}
+
+bool TranspositionTable::allocate(const usize bytes) noexcept
+{
+#ifdef __linux__
+#	if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+	// Explicit huge pages are only available if they have been reserved by the administrator
+	for (const usize pageShift : { 30u, 21u })
+	{
+		const usize pageSize = usize(1) << pageShift;
+		if (bytes < pageSize)
+			continue;
+
+		const usize mappedBytes = roundUp(bytes, pageSize);
+		void *memory = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE,
+							MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | int(pageShift << MAP_HUGE_SHIFT), -1, 0);
+
+		if (memory != MAP_FAILED)
+		{
+			_clusters = static_cast<Cluster *>(memory);
+			_mappedBytes = mappedBytes;
+			_pageSize = pageSize;
+			_pageType = PageType::HUGE;
+			return true;
+		}
+	}
+#	endif
+
+	// Otherwise ask for transparent huge pages, which requires the mapping to be aligned to the huge page size
+	const usize mappedBytes = roundUp(bytes, HUGE_PAGE_SIZE);
+	void *memory = mmap(nullptr, mappedBytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+						MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (memory != MAP_FAILED)
+	{
+		// Unmap the unaligned head and the tail
+		auto *const start = static_cast<u8 *>(memory);
+		auto *const alignedStart = reinterpret_cast<u8 *>(
+			roundUp(reinterpret_cast<uintptr_t>(start), HUGE_PAGE_SIZE));
+
+		if (alignedStart != start)
+			munmap(start, usize(alignedStart - start));
+		munmap(alignedStart + mappedBytes, HUGE_PAGE_SIZE - usize(alignedStart - start));
+
+		_clusters = reinterpret_cast<Cluster *>(alignedStart);
+		_mappedBytes = mappedBytes;
+		_pageSize = usize(sysconf(_SC_PAGESIZE));
+		_pageType = PageType::NORMAL;
+
+#	ifdef MADV_HUGEPAGE
+		if (areTransparentHugePagesEnabled() && madvise(alignedStart, mappedBytes, MADV_HUGEPAGE) == 0)
+		{
+			_pageSize = HUGE_PAGE_SIZE;
+			_pageType = PageType::TRANSPARENT_HUGE;
+		}
+#	endif
+		return true;
+	}
+#endif
+
+	_clusters = static_cast<Cluster *>(
+		operator new[](bytes, std::align_val_t{ alignof(Cluster) }, std::nothrow));
+	_mappedBytes = 0;
+	_pageSize = 0;
+	_pageType = PageType::NORMAL;
+
+	return _clusters != nullptr;
+}
+
+void TranspositionTable::deallocate() noexcept
+{
+	if (!_clusters)
+		return;
+
+#ifdef __linux__
+	if (isShared())
+		munmap(reinterpret_cast<u8 *>(_clusters) - FILE_HEADER_SIZE, FILE_HEADER_SIZE + _mappedBytes);
+	else if (_mappedBytes != 0)
+		munmap(_clusters, _mappedBytes);
+	else
+#endif
+		operator delete[](_clusters, std::align_val_t{ alignof(Cluster) });
+
+	_clusters = nullptr;
+	_mappedBytes = 0;
+	_zeroed = false;
+	_fileBacked = false;
+	_sharedName.clear();
+	_sharedHeader = nullptr;
+}
+
+TranspositionTable::Cluster &TranspositionTable::getCluster(const u64 zKey) const noexcept
+{
+	const auto index = usize(mulHigh64(zKey, _size));
+	assert(index < _size);
+	return _clusters[index];
 }
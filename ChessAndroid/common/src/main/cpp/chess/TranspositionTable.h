@@ -1,8 +1,10 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <bit>
 #include <optional>
-#include <shared_mutex>
+#include <string>
 
 #include "Move.h"
 
@@ -21,16 +23,24 @@ public:
 
 	SearchEntry() = default;
 
-	constexpr SearchEntry(const u64 key, const int depth, const Move move, const bool qSearch, const Bound bound)
-		: _key16(key >> 48u), _moveFromTo(move.getFromToBits()), _value(move.getScore()), _depth8(i8(depth))
+	constexpr SearchEntry(const int depth, const Move move, const bool qSearch, const Bound bound,
+						  const int eval = VALUE_NONE)
+		: _move(u16(move.getFromToBits() | (move.promotedPiece() << 12u))),
+		  _value(move.getScore()), _depth8(i8(depth)), _eval(i16(eval))
 	{
 		_field.setAs<1>(bound);
 		_field.setAs<2>(qSearch);
 	}
 
-	[[nodiscard]] constexpr u16 key() const noexcept { return _key16; }
-
-	[[nodiscard]] constexpr Move move() const noexcept { return Move{ _moveFromTo, i32(_value) }; }
+	/**
+	 * Only the squares and the promoted piece of the move are stored
+	 */
+	[[nodiscard]] constexpr Move move() const noexcept
+	{
+		Move move{ _move & FROM_TO_MASK, i32(_value) };
+		move.setPromotedPiece(PieceType(_move >> 12u));
+		return move;
+	}
 
 	[[nodiscard]] constexpr i32 depth() const noexcept { return i32(_depth8); }
 
@@ -40,14 +50,18 @@ public:
 
 	[[nodiscard]] constexpr bool qSearch() const noexcept { return _field.getAs<2, bool>(); }
 
+	/**
+	 * Static evaluation of the position for the side to move, VALUE_NONE if it was in check
+	 */
+	[[nodiscard]] constexpr i32 eval() const noexcept { return i32(_eval); }
+
 	constexpr void setAge(const u8 newAge) noexcept
 	{
 		_field.set<0>(newAge);
 	}
 
 private:
-	u16 _key16{};
-	u16 _moveFromTo{};
+	u16 _move{};
 	i16 _value{};
 	i8 _depth8{};
 
@@ -57,20 +71,83 @@ private:
 	 * 2 - qSearch
 	 */
 	Bitfield<u8, 5, 2, 1> _field{};
+	i16 _eval{ VALUE_NONE };
 
 	static constexpr auto AGE_MASK = (1u << 5u) - 1u;
+	static constexpr u32 FROM_TO_MASK = (1u << 12u) - 1u;
 };
 
+static_assert(sizeof(SearchEntry) == sizeof(u64), "SearchEntry must fill the data of a Slot");
+
 class TranspositionTable
 {
 	static constexpr usize CLUSTER_SIZE = 4;
+	static constexpr usize CACHE_LINE_SIZE = 64;
+	static constexpr usize HASHFULL_SAMPLE_SLOTS = 1000;
+
+	/**
+	 * The table is shared by all threads without locking, so the full key is stored XOR-ed with the data.
+	 * A slot whose halves were written by different threads, or that belongs to another position,
+	 * fails the key check instead of returning the data of another position
+	 */
+	class Slot
+	{
+	public:
+		[[nodiscard]] u64 key(const u64 data) const noexcept { return _key.load(std::memory_order_relaxed) ^ data; }
+
+		[[nodiscard]] u64 data() const noexcept { return _data.load(std::memory_order_relaxed); }
+
+		void store(const u64 key, const u64 data) noexcept
+		{
+			_key.store(key ^ data, std::memory_order_relaxed);
+			_data.store(data, std::memory_order_relaxed);
+		}
+
+		static u64 toData(const SearchEntry &entry) noexcept
+		{
+			return std::bit_cast<u64>(entry);
+		}
+
+		static SearchEntry toEntry(const u64 data) noexcept
+		{
+			return std::bit_cast<SearchEntry>(data);
+		}
+
+	private:
+		std::atomic<u64> _key;
+		std::atomic<u64> _data;
+	};
 
-	struct Cluster
+	// Only lock-free atomics are address-free, which is required for sharing them with other processes
+	static_assert(std::atomic<u64>::is_always_lock_free, "Slot must be lock-free");
+
+	struct alignas(CACHE_LINE_SIZE) Cluster
+	{
+		std::array<Slot, CLUSTER_SIZE> slots;
+	};
+
+	static_assert(sizeof(Cluster) == CACHE_LINE_SIZE, "Wrong Cluster Size");
+
+	struct FileHeader
 	{
-		std::array<SearchEntry, CLUSTER_SIZE> entries;
+		std::array<char, 8> magic;
+		u32 version;
+		u32 clusterBytes;
+		u64 clusterCount;
+		u64 keySignature;
+		u8 ageMask;
+		u8 currentAge;
 	};
 
-	static_assert(sizeof(Cluster) == 32, "Wrong Cluster Size");
+	static constexpr std::array<char, 8> FILE_MAGIC = { 'C', 'H', 'E', 'S', 'S', 'T', 'T', '\0' };
+	static constexpr u32 FILE_VERSION = 3;
+
+	/**
+	 * The clusters start at a page boundary in the file, so that they can be mapped directly.
+	 * 64KB is a multiple of every page size in use, including the 16KB and 64KB pages of some ARM kernels
+	 */
+	static constexpr usize FILE_HEADER_SIZE = 64 * 1024;
+	static_assert(FILE_HEADER_SIZE >= sizeof(FileHeader));
 
 public:
 	explicit TranspositionTable(usize sizeMb);
@@ -87,13 +164,111 @@ public:
 
 	void insert(u64 zKey, SearchEntry entry) noexcept;
 	bool setSize(usize sizeMb);
+	/**
+	 * Starts a new search by moving to the next age, the age of a shared table is kept in its header
+	 * so that all the engines using it agree on which entries are from an older search
+	 */
 	void update() noexcept;
 	[[nodiscard]] u8 currentAge() const noexcept;
-	void clear() noexcept;
+
+	/**
+	 * Approximate permille of the table used by the current search, sampled from its first clusters
+	 */
+	[[nodiscard]] int hashfull() const noexcept;
+
+	/**
+	 * Scans the whole table and formats a histogram of the depth, bound and age of its entries
+	 */
+	[[nodiscard]] std::string formatHistogram() const;
+
+	/**
+	 * Writes the table to a temporary file, after a header describing its layout, then replaces the file with it.
+	 * The keySignature identifies the hashing scheme of the keys, a table can only be loaded with the same one
+	 */
+	bool save(const std::string &path, u64 keySignature) const;
+
+	/**
+	 * Replaces the table with the one saved in the file, if its header matches this build and the keySignature.
+	 * On Linux the file is mapped copy-on-write, so its pages are only read once they are used,
+	 * otherwise or if it can not be mapped it is read into a new table
+	 */
+	bool load(const std::string &path, u64 keySignature);
+
+	/**
+	 * Maps the table from a named POSIX shared memory segment, creating it with sizeMb if it does not exist yet.
+	 * Every engine process mapping the same segment shares its entries and their age, while an empty name goes back
+	 * to a private table of sizeMb. The segment is kept after the process exits, until it is removed from /dev/shm
+	 */
+	bool setShared(const std::string &name, usize sizeMb, u64 keySignature);
+
+	[[nodiscard]] bool isShared() const noexcept { return !_sharedName.empty(); }
+
+	/**
+	 * Clears one of partCount equal parts of the table, so that multiple threads can clear it at the same time
+	 */
+	void clear(usize partIndex = 0, usize partCount = 1) noexcept;
+
+	enum class PageType : u8
+	{
+		NORMAL,
+		// Only requested, the kernel decides which parts of the table actually get huge pages
+		TRANSPARENT_HUGE,
+		HUGE
+	};
+
+	[[nodiscard]] usize sizeMb() const noexcept { return _size * sizeof(Cluster) >> 20u; }
+
+	[[nodiscard]] PageType pageType() const noexcept { return _pageType; }
+
+	/**
+	 * Size in bytes of the pages backing the table, 0 if it is not known
+	 */
+	[[nodiscard]] usize pageSize() const noexcept { return _pageSize; }
 
 private:
+	/**
+	 * On Linux the table is mapped with explicit huge pages if any have been reserved,
+	 * then with transparent huge pages, otherwise it falls back to a normal allocation
+	 */
+	bool allocate(usize bytes) noexcept;
+	[[nodiscard]] u8 ageDistance(u8 age) const noexcept;
+	[[nodiscard]] FileHeader makeHeader(usize clusterCount, u64 keySignature) const noexcept;
+
+	/**
+	 * Returns why a header does not describe a usable table of totalBytes, including the header, or nullptr
+	 */
+	[[nodiscard]] static const char *checkHeader(const FileHeader &header, u64 keySignature,
+												 usize totalBytes) noexcept;
+
+	void deallocate() noexcept;
+
+	/**
+	 * Every key is mapped to one of all the allocated clusters, by prefetch, probe and insert alike
+	 */
+	[[nodiscard]] Cluster &getCluster(u64 zKey) const noexcept;
+
 	usize _size{};
-	u64 _hashMask{};
 	u8 _currentAge{};
 	Cluster *_clusters = nullptr;
+	usize _mappedBytes{};
+	usize _pageSize{};
+	PageType _pageType{};
+	/**
+	 * The table is a private mapping of a saved file, releasing its pages would bring back the file contents
+	 */
+	bool _fileBacked{};
+	/**
+	 * Name of the shared memory segment the table is mapped from, the header is mapped right before the clusters
+	 */
+	std::string _sharedName{};
+	/**
+	 * Header of the shared memory segment, mapped right before the clusters
+	 */
+	FileHeader *_sharedHeader{};
+
+	/**
+	 * Set while nothing has been stored since the table was allocated or cleared,
+	 * entries are only stored by searches, which always start by calling update
+	 */
+	bool _zeroed{};
 };
@@ -53,14 +53,18 @@ void Uci::loop()
 			setOption(is);
 		else if (token == "board")
 			std::cout << _board.toString() << std::endl;
+		else if (token == "ponderhit")
+			Search::ponderHit();
 		else if (token == "stop")
 		{
 			Search::stopSearch();
-			if (_searchThread.joinable())
-				_searchThread.join();
-			std::cout << "Joined Thread\n";
+			Search::waitForSearch();
 		} else if (token == "quit")
+		{
+			Search::stopSearch();
+			Search::waitForSearch();
 			quit = true;
+		}
 
 			// Non-UCI Commands
 		else if (token == "usermove")
@@ -74,8 +78,6 @@ void Uci::loop()
 				std::cout << "Move could not be parsed";
 			else if (!MoveList(_board).contains(move))
 				std::cout << "Move is invalid";
-			else if (!_board.isMoveLegal(move))
-				std::cout << "Move is illegal";
 			else
 			{
 				_board.makeMove(move);
@@ -110,6 +112,41 @@ void Uci::loop()
 				std::cout << "Test Completed Successfully\n";
 			else
 				std::cout << results;
+		} else if (token == "tttest")
+		{
+			const auto results = Tests::runTranspositionTableStressTest();
+			if (results.empty())
+				std::cout << "Test Completed Successfully\n";
+			else
+				std::cout << results;
+		} else if (token == "benchtest")
+		{
+			const auto results = Tests::runBenchmarkRepeatTest();
+			if (results.empty())
+				std::cout << "Test Completed Successfully\n";
+			else
+				std::cout << results;
+		} else if (token == "hashstats")
+		{
+			std::cout << Search::getTranspTable().formatHistogram();
+		} else if (token == "savehash")
+		{
+			std::string path;
+			std::getline(is >> std::ws, path);
+
+			if (Search::saveTable(path))
+				std::cout << "info string Hash table saved to " << path << std::endl;
+		} else if (token == "loadhash")
+		{
+			std::string path;
+			std::getline(is >> std::ws, path);
+
+			if (Search::loadTable(path))
+			{
+				// Keep the loaded table, instead of resizing it at the next search
+				_hashSizeMb = Search::getTranspTable().sizeMb();
+				std::cout << "info string Hash table of " << _hashSizeMb << "MB loaded from " << path << std::endl;
+			}
 		} else if (token == "perft")
 		{
 			i32 depth{};
@@ -118,7 +155,21 @@ void Uci::loop()
 				Tests::runPerftForPosition(_board.getFen(), depth);
 			else
 				Tests::runPerftTests();
-
+		} else if (token == "bench")
+		{
+			i32 depth{};
+			usize hashSizeMb{};
+			is >> depth >> hashSizeMb;
+			Tests::runBenchmark(depth, hashSizeMb);
+		} else if (token == "gamebench")
+		{
+			i32 depth{};
+			usize hashSizeMb{};
+			is >> depth >> hashSizeMb;
+			Tests::runGameBenchmark(depth, hashSizeMb);
+		} else if (token == "attacksbench")
+		{
+			Tests::runAttacksBenchmark();
 		}
 
 		std::cout.flush();
@@ -133,46 +184,112 @@ void Uci::loop()
 void Uci::setOption(std::istringstream &is)
 {
 	std::string token;
+	std::string name;
+	std::string value;
+
 	is >> token;
+	if (token == "name")
+	{
+		// Option names may contain spaces, so everything up to "value" is part of the name
+		while (is >> token && token != "value")
+			name += name.empty() ? token : ' ' + token;
+		while (is >> token)
+			value += value.empty() ? token : ' ' + token;
+	} else
+	{
+		// Short form: setoption <name> <value>
+		name = token;
+		is >> value;
+	}
 
-	if (token == "Threads")
+	std::istringstream valueStream(value);
+
+	if (name == "Threads")
 	{
 		usize threadCount{};
-		is >> threadCount;
+		valueStream >> threadCount;
 		_threadCount = std::clamp<usize>(threadCount, 1u, 128u);
+		Search::setThreadCount(_threadCount);
 
 		std::cout << "Thread Count has been set to " << _threadCount << std::endl;
-	} else if (token == "Hash")
+	} else if (name == "Hash")
 	{
 		usize hashSize{};
-		is >> hashSize;
-		_hashSizeMb = std::clamp<usize>(hashSize, 2u, 8192u);
+		valueStream >> hashSize;
+		_hashSizeMb = std::clamp<usize>(hashSize, 2u, MAX_HASH_SIZE_MB);
 
-		std::cout << "Hash Size has been set to " << _hashSizeMb << "MB" << std::endl;
-	} else if (token == "BookPath")
+		// The size of a shared table is decided by the engine that created it
+		if (const auto &table = Search::getTranspTable(); table.isShared())
+			std::cout << "Hash Size stays at the " << table.sizeMb() << "MB of the Shared Hash, "
+					  << _hashSizeMb << "MB will be used once it is turned off" << std::endl;
+		else
+			std::cout << "Hash Size has been set to " << _hashSizeMb << "MB" << std::endl;
+	} else if (name == "Move Overhead" || name == "MoveOverhead")
 	{
-		is >> token;
-		if (token == "null")
+		i64 moveOverhead{};
+		valueStream >> moveOverhead;
+		_moveOverhead = std::clamp<i64>(moveOverhead, 0, 5000);
+
+		std::cout << "Move Overhead has been set to " << _moveOverhead << "ms" << std::endl;
+	} else if (name == "MultiPV")
+	{
+		usize multiPv{};
+		valueStream >> multiPv;
+		_multiPv = std::clamp<usize>(multiPv, 1u, 256u);
+
+		std::cout << "MultiPV has been set to " << _multiPv << std::endl;
+	} else if (name == "BookPath")
+	{
+		if (value == "null")
 			PolyBook::clearBook();
 		else
-			PolyBook::initBook(token);
+			PolyBook::initBook(value);
+	} else if (name == "SharedHash")
+	{
+		if (value == "null")
+			value.clear();
+
+		if (Search::setSharedTable(value, _hashSizeMb))
+		{
+			// The size of a shared table is decided by the engine that created it
+			_hashSizeMb = Search::getTranspTable().sizeMb();
+
+			if (value.empty())
+				std::cout << "Shared Hash has been turned off" << std::endl;
+			else
+				std::cout << "Shared Hash of " << _hashSizeMb << "MB has been set to " << value << std::endl;
+		}
 	}
 }
 
 void Uci::parseGo(std::istringstream &is)
 {
 	i32 depth = MAX_DEPTH;
-	i32 movesToGo = 35;
-	i64 moveTime = -1;
-	i64 time = -1;
-	bool timeSet = false;
-	i64 inc = 0;
-	bool infinite = false;
+	i32 movesToGo{};
+	u64 nodes{};
+	i64 moveTime{};
+	i64 time{};
+	i64 inc{};
+	bool infinite{};
+	bool ponder{};
+	bool readingSearchMoves{};
+	std::vector<Move> searchMoves;
 
 	std::string token;
 
 	while (is >> token)
 	{
+		// The list of moves ends at the next token that is not a move
+		if (readingSearchMoves)
+		{
+			if (const Move move = parseMove(_board, token); !move.empty())
+			{
+				searchMoves.push_back(move);
+				continue;
+			}
+			readingSearchMoves = false;
+		}
+
 		if (_board.colorToMove == WHITE)
 		{
 			if (token == "wtime")
@@ -189,49 +306,32 @@ void Uci::parseGo(std::istringstream &is)
 
 		if (token == "infinite")
 			infinite = true;
+		else if (token == "ponder")
+			ponder = true;
+		else if (token == "searchmoves")
+			readingSearchMoves = true;
 		else if (token == "movestogo")
 			is >> movesToGo;
 		else if (token == "movetime")
 			is >> moveTime;
 		else if (token == "depth")
 			is >> depth;
+		else if (token == "nodes")
+			is >> nodes;
 	}
 
-	if (moveTime != -1)
-	{
-		timeSet = true;
-		time = moveTime;
-		movesToGo = 1;
-	}
-
-	if (time != -1)
-	{
-		timeSet = true;
-		time /= movesToGo;
-		time -= 50;
-		time += inc / 2;
-	}
-
-	if (timeSet)
-		time = std::max<i64>(5, time);
-
-	if (infinite)
-	{
-		time = 0;
-		timeSet = false;
-	}
-
-	std::cout << "time: " << time << " depth: " << depth
-			  << " timeSet: " << std::boolalpha << timeSet << std::endl;
-
-	const i64 searchTime = timeSet ? time : 0;
-	const SearchOptions options{ depth, _threadCount, _hashSizeMb, true, searchTime };
-
-	if (_searchThread.joinable())
-		_searchThread.detach();
-	Stats::resetStats();
-
-	_searchThread = std::thread(Search::findBestMove, _board, options);
+	// The Time Manager decides how much of the clock to use
+	SearchOptions options{ depth, _threadCount, _hashSizeMb, true, infinite ? 0 : std::max<i64>(moveTime, 0) };
+	if (!infinite)
+		options.setClock(time, inc, movesToGo);
+	options.setMoveOverhead(_moveOverhead);
+	options.setNodesLimit(nodes);
+	options.setPonder(ponder);
+	options.setInfinite(infinite);
+	options.setMultiPv(_multiPv);
+	options.setSearchMoves(std::move(searchMoves));
+
+	Search::startSearch(_board, options);
 }
 
 void Uci::parsePosition(std::istringstream &is)
@@ -278,7 +378,11 @@ void Uci::printEngineInfo()
 	std::cout << "id name LuckyEngine\n"
 			  << "id author Filea (TheLuckyCoder) Filea Razvan\n\n"
               << "option name Threads type spin default 1 min 1 max 128\n"
-              << "option name Hash type spin default 64 min 2 max 8192\n"
+              << "option name Hash type spin default 64 min 2 max " << MAX_HASH_SIZE_MB << '\n'
+              << "option name Ponder type check default false\n"
+              << "option name MultiPV type spin default 1 min 1 max 256\n"
+              << "option name Move Overhead type spin default 30 min 0 max 5000\n"
               << "option name BookPath type string\n"
+              << "option name SharedHash type string\n"
 			  << "uciok" << std::endl;
 }
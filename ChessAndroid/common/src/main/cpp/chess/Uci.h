@@ -12,9 +12,13 @@
  */
 class Uci
 {
-	inline static std::thread _searchThread{};
+	// A 32-bit address space could not map a larger table anyway
+	static constexpr usize MAX_HASH_SIZE_MB = sizeof(void *) >= 8 ? 65536u : 8192u;
+
 	inline static usize _threadCount{ std::thread::hardware_concurrency() - 1u };
 	inline static usize _hashSizeMb{ 64 };
+	inline static i64 _moveOverhead{ 30 };
+	inline static usize _multiPv{ 1 };
 	inline static Board _board{};
 
 public:
@@ -51,6 +51,7 @@ namespace Zobrist
 	static const u64 SideKey{ Generator.random64() };
 	static const auto CastlingRightsKeys{ Generator.randomArray<4>() };
 	static const auto EnPassantKeys{ Generator.randomArray<8>() };
+	static const auto CastledKeys{ Generator.randomArray<COLOR_NB>() };
 
 	u64 compute(const Board &board) noexcept
 	{
@@ -90,11 +91,17 @@ namespace Zobrist
 			key ^= CastlingRightsKeys[2];
 		if (rights & CASTLE_BLACK_QUEEN)
 			key ^= CastlingRightsKeys[3];
+
+		// Whether a side has castled is part of the evaluation, so it must be part of the key too
+		if (rights & CASTLED_WHITE)
+			key ^= CastledKeys[WHITE];
+		if (rights & CASTLED_BLACK)
+			key ^= CastledKeys[BLACK];
 	}
 
 	void xorEnPassant(u64 &key, const Square square) noexcept
 	{
-		if (square <= SQUARE_NB)
+		if (square < SQUARE_NB)
 			key ^= EnPassantKeys[fileOf(square)];
 	}
 }
\ No newline at end of file
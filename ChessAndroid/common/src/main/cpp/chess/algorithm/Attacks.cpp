@@ -1,5 +1,12 @@
 #include "Attacks.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#	define PEXT_AVAILABLE
+#	include <cpuid.h>
+
+#endif
+
 static constexpr std::array<u8, SQUARE_NB> BishopIndexBits = {
 	6, 5, 5, 5, 5, 5, 5, 6,
 	5, 5, 5, 5, 5, 5, 5, 5,
@@ -92,21 +99,6 @@ static constexpr auto RookMasks = []
 	return masks;
 }();
 
-constexpr u64 getBlockersFromIndex(const int index, Bitboard mask)
-{
-	u64 blockers{};
-	const int bits = mask.count();
-
-	for (int i = 0; i < bits; i++)
-	{
-		const u8 bitPos = mask.popLsb();
-		if (index & (1 << i))
-			blockers |= Bits::Squares[bitPos];
-	}
-
-	return blockers;
-}
-
 static constexpr auto KnightAttacks = []
 {
 	std::array<Bitboard, SQUARE_NB> moves{};
@@ -148,9 +140,155 @@ static constexpr auto KingAttacks = []
 	return moves;
 }();
 
-static std::array<std::array<Bitboard, 1024>, SQUARE_NB> BishopAttacks;
+/**
+ * Everything needed to find the attacks of a sliding piece from one square in the shared table,
+ * aligned so that it never straddles two cache lines
+ */
+struct alignas(32) SlidingSquare
+{
+	Bitboard mask;
+	u64 magic;
+	u32 offset;
+	u8 shift;
+};
+
+// The magics use as many index bits as there are squares in the mask, like PEXT, so both share the same layout
+static_assert([]
+{
+	for (u8 square{}; square < SQUARE_NB; ++square)
+	{
+		if (BishopMasks[square].count() != BishopIndexBits[square]
+			|| RookMasks[square].count() != RookIndexBits[square])
+			return false;
+	}
+
+	return true;
+}());
+
+static constexpr auto getSlidingSquares(const std::array<Bitboard, SQUARE_NB> &masks,
+										const std::array<u64, SQUARE_NB> &magics,
+										const std::array<u8, SQUARE_NB> &indexBits, u32 offset)
+{
+	std::array<SlidingSquare, SQUARE_NB> squares{};
+
+	for (u8 square{}; square < SQUARE_NB; ++square)
+	{
+		squares[square] = { masks[square], magics[square], offset, u8(64u - indexBits[square]) };
+		offset += 1u << indexBits[square];
+	}
+
+	return squares;
+}
+
+static constexpr u32 getTableEnd(const std::array<SlidingSquare, SQUARE_NB> &squares)
+{
+	return squares.back().offset + (1u << (64u - squares.back().shift));
+}
+
+// The Bishop attacks come first in the table, followed by the Rook ones
+static constexpr auto BishopSquares = getSlidingSquares(BishopMasks, BishopMagics, BishopIndexBits, 0);
+static constexpr auto RookSquares = getSlidingSquares(RookMasks, RookMagics, RookIndexBits,
+													  getTableEnd(BishopSquares));
 
-static std::array<std::array<Bitboard, 4096>, SQUARE_NB> RookAttacks;
+/**
+ * Generates the attacks of the Bishops and Rooks for every set of blockers, each square only taking as many entries
+ * as its index bits need: 841KB instead of the 2.5MB of giving every square the size of the largest one.
+ * This runs at compile time, so the table is part of the read-only data of the binary and is only paged in when used
+ */
+template <typename GetIndex>
+static consteval auto generateSlidingAttacks(const GetIndex getIndex)
+{
+	std::array<Bitboard, getTableEnd(RookSquares)> table{};
+
+	for (u8 square{}; square < SQUARE_NB; ++square)
+	{
+		const auto &slidingSquare = BishopSquares[square];
+
+		const u64 mask = slidingSquare.mask.value();
+		u64 blockers{};
+
+		// For all possible blockers for this square, in the same order as their index
+		for (int blockerIndex{}; blockerIndex < (1 << BishopIndexBits[square]); ++blockerIndex)
+		{
+			const u64 attacks = Bits::generateBishopAttacks(square, blockers);
+			table[slidingSquare.offset + getIndex(slidingSquare, blockers, blockerIndex)] = Bitboard{ attacks };
+
+			// Carry-Rippler trick, which finds the next subset of the mask
+			blockers = (blockers - mask) & mask;
+		}
+	}
+
+	for (u8 square{}; square < SQUARE_NB; ++square)
+	{
+		const auto &slidingSquare = RookSquares[square];
+
+		const u64 mask = slidingSquare.mask.value();
+		u64 blockers{};
+
+		// For all possible blockers for this square, in the same order as their index
+		for (int blockerIndex{}; blockerIndex < (1 << RookIndexBits[square]); ++blockerIndex)
+		{
+			const u64 attacks = Bits::generateRookAttacks(square, blockers);
+			table[slidingSquare.offset + getIndex(slidingSquare, blockers, blockerIndex)] = Bitboard{ attacks };
+
+			// Carry-Rippler trick, which finds the next subset of the mask
+			blockers = (blockers - mask) & mask;
+		}
+	}
+
+	return table;
+}
+
+alignas(64) static constexpr auto MagicSlidingAttacks = generateSlidingAttacks(
+	[](const SlidingSquare &slidingSquare, const u64 blockers, int)
+	{
+		return u32((blockers * slidingSquare.magic) >> slidingSquare.shift);
+	});
+
+static Attacks::SliderBackend Backend = Attacks::SliderBackend::MAGICS;
+static bool PextSupported = false;
+
+#ifdef PEXT_AVAILABLE
+
+/**
+ * PEXT is microcoded on the AMD CPUs before Zen 3, where it is a lot slower than the magics
+ */
+static bool hasFastPext() noexcept
+{
+	u32 eax{}, ebx{}, ecx{}, edx{};
+	if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !(ebx & bit_BMI2))
+		return false;
+
+	__get_cpuid(0, &eax, &ebx, &ecx, &edx);
+	const bool isAmd = ebx == signature_AMD_ebx && ecx == signature_AMD_ecx && edx == signature_AMD_edx;
+
+	__get_cpuid(1, &eax, &ebx, &ecx, &edx);
+	u32 family = (eax >> 8) & 0xFu;
+	if (family == 0xFu)
+		family += (eax >> 20) & 0xFFu;
+
+	return !isAmd || family >= 0x19u;
+}
+
+/**
+ * Written in assembly, unlike _pext_u64 this does not require the whole caller to be compiled for BMI2,
+ * so the lookups can still be inlined behind the check of the backend
+ */
+force_inline static u64 pext(const u64 value, const u64 mask) noexcept
+{
+	u64 result;
+	asm("pextq %2, %1, %0" : "=r"(result) : "r"(value), "r"(mask));
+	return result;
+}
+
+// The blockers of an index are already ordered like PEXT would extract them
+alignas(64) static constexpr auto PextSlidingAttacks = generateSlidingAttacks(
+	[](const SlidingSquare &, u64, const int blockerIndex)
+	{
+		return u32(blockerIndex);
+	});
+
+#endif
 
 static constexpr auto BishopXRayAttacks = []
 {
@@ -182,41 +320,47 @@ static constexpr auto RookXRayAttacks = []
 	return moves;
 }();
 
+force_inline static Bitboard getSlidingAttacks(const SlidingSquare &slidingSquare, const Bitboard blockers) noexcept
+{
+#ifdef PEXT_AVAILABLE
+	if (Backend == Attacks::SliderBackend::PEXT)
+		return PextSlidingAttacks[slidingSquare.offset + pext(blockers.value(), slidingSquare.mask.value())];
+#endif
+
+	const u64 relevantBlockers = (blockers & slidingSquare.mask).value();
+	return MagicSlidingAttacks[slidingSquare.offset + ((relevantBlockers * slidingSquare.magic) >> slidingSquare.shift)];
+}
+
 void Attacks::init()
 {
 	static bool initialized = false;
 	if (initialized) return;
 	initialized = true;
 
-	for (u8 square{}; square < SQUARE_NB; ++square)
-	{
-		const int indexBit = BishopIndexBits[square];
+#ifdef PEXT_AVAILABLE
+	PextSupported = hasFastPext();
+#endif
 
-		// For all possible blockers for this square
-		for (int blockerIndex{}; blockerIndex < (1 << indexBit); ++blockerIndex)
-		{
-			const u64 blockers = getBlockersFromIndex(blockerIndex, BishopMasks[square]);
-			const u64 attacks = Bits::generateBishopAttacks(square, blockers);
-			const u64 index = (blockers * BishopMagics[square]) >> (64 - indexBit);
+	Backend = PextSupported ? SliderBackend::PEXT : SliderBackend::MAGICS;
+}
 
-			BishopAttacks[square][index] = Bitboard{ attacks };
-		}
-	}
+bool Attacks::isPextSupported() noexcept
+{
+	return PextSupported;
+}
 
-	for (u8 square{}; square < SQUARE_NB; ++square)
-	{
-		const int indexBit = RookIndexBits[square];
+Attacks::SliderBackend Attacks::getSliderBackend() noexcept
+{
+	return Backend;
+}
 
-		// For all possible blockers for this square
-		for (int blockerIndex{}; blockerIndex < (1 << indexBit); ++blockerIndex)
-		{
-			const u64 blockers = getBlockersFromIndex(blockerIndex, RookMasks[square]);
-			const u64 attacks = Bits::generateRookAttacks(square, blockers);
-			const u64 index = (blockers * RookMagics[square]) >> (64 - indexBit);
+bool Attacks::setSliderBackend(const SliderBackend backend) noexcept
+{
+	if (backend == SliderBackend::PEXT && !PextSupported)
+		return false;
 
-			RookAttacks[square][index] = Bitboard{ attacks };
-		}
-	}
+	Backend = backend;
+	return true;
 }
 
 Bitboard Attacks::knightAttacks(const Square square) noexcept
@@ -224,18 +368,14 @@ Bitboard Attacks::knightAttacks(const Square square) noexcept
 	return KnightAttacks[square];
 }
 
-Bitboard Attacks::bishopAttacks(const Square square, Bitboard blockers) noexcept
+Bitboard Attacks::bishopAttacks(const Square square, const Bitboard blockers) noexcept
 {
-	blockers &= BishopMasks[square];
-	const u64 key = (blockers.value() * BishopMagics[square]) >> (64u - BishopIndexBits[square]);
-	return BishopAttacks[square][key];
+	return getSlidingAttacks(BishopSquares[square], blockers);
 }
 
-Bitboard Attacks::rookAttacks(const Square square, Bitboard blockers) noexcept
+Bitboard Attacks::rookAttacks(const Square square, const Bitboard blockers) noexcept
 {
-	blockers &= RookMasks[square];
-	const u64 key = (blockers.value() * RookMagics[square]) >> (64u - RookIndexBits[square]);
-	return RookAttacks[square][key];
+	return getSlidingAttacks(RookSquares[square], blockers);
 }
 
 Bitboard Attacks::queenAttacks(const Square square, const Bitboard blockers) noexcept
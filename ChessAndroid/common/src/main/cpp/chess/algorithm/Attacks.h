@@ -5,6 +5,16 @@
 class Attacks
 {
 public:
+	/**
+	 * The ways the attacks of the sliding pieces can be looked up:
+	 * multiply-shift magic indexing or the BMI2 PEXT instruction
+	 */
+	enum class SliderBackend : u8
+	{
+		MAGICS,
+		PEXT
+	};
+
 	Attacks() = delete;
 	Attacks(const Attacks &) = delete;
 	Attacks(Attacks &&) = delete;
@@ -13,8 +23,19 @@ public:
 	Attacks &operator=(const Attacks &) = delete;
 	Attacks &operator=(Attacks &&) = delete;
 
+	/**
+	 * Picks PEXT if the CPU has a fast implementation of it, the attack tables themselves are generated at compile time
+	 */
 	static void init();
 
+	[[nodiscard]] static bool isPextSupported() noexcept;
+	[[nodiscard]] static SliderBackend getSliderBackend() noexcept;
+
+	/**
+	 * @return false if the backend is not supported by this CPU, in which case the current one is kept
+	 */
+	static bool setSliderBackend(SliderBackend backend) noexcept;
+
 	static Bitboard knightAttacks(Square square) noexcept;
 	static Bitboard bishopAttacks(Square square, Bitboard blockers) noexcept;
 	static Bitboard rookAttacks(Square square, Bitboard blockers) noexcept;
@@ -6,7 +6,7 @@
 #include "../Stats.h"
 #include "../Board.h"
 #include "../MoveGen.h"
-#include "../MoveOrdering.h"
+#include "../MovePicker.h"
 #include "Evaluation.h"
 #include "../Psqt.h"
 #include "../polyglot/PolyBook.h"
@@ -21,6 +21,9 @@ static constexpr int FUTILITY_QUIESCENCE_MARGIN = 100;
 static constexpr int FUTILITY_MARGIN = 160;
 static constexpr int FUTILITY_MAX_DEPTH = 8;
 
+// How many nodes a thread searches before adding them to the shared counter and checking the limits
+static constexpr usize NODES_CHECK_INTERVAL = 2048;
+
 static thread_local Thread *localThreadInfo = nullptr;
 
 auto &threadInfo() { return *localThreadInfo; }
@@ -28,47 +31,148 @@ auto &threadInfo() { return *localThreadInfo; }
 SearchOptions Search::_searchOptions;
 TranspositionTable Search::_transpositionTable{ _searchOptions.tableSizeMb() };
 Search::SharedState Search::_sharedState{};
+ThreadPool Search::_threadPool{};
+TimeManager Search::_timeManager{};
+RootMoves Search::_rootMoves{};
 
 void Search::clearAll()
 {
-	_transpositionTable.clear();
+	stopSearch();
+	waitForSearch();
+
 	_sharedState.fullReset();
+
+	// Every worker clears its own tables and an equal part of the hash table
+	const usize threadCount = _threadPool.size();
+	if (threadCount != 0)
+	{
+		_threadPool.start([threadCount](Thread &thread)
+		{
+			thread.clear();
+			_transpositionTable.clear(thread.threadId - 1, threadCount);
+		});
+		_threadPool.wait();
+	} else
+		_transpositionTable.clear();
 }
 
 void Search::stopSearch()
 {
-	_sharedState.stopped = true;
+	{
+		std::lock_guard lock{ _sharedState.mutex };
+		_sharedState.stopped = true;
+	}
+	_sharedState.stopCondition.notify_all();
+}
+
+void Search::ponderHit()
+{
+	_timeManager.ponderHit();
+
+	// The main thread has either seen the ponder hit already or is waiting for this notification
+	{
+		std::lock_guard lock{ _sharedState.mutex };
+	}
+	_sharedState.stopCondition.notify_all();
+}
+
+bool Search::saveTable(const std::string &path)
+{
+	stopSearch();
+	waitForSearch();
+
+	return _transpositionTable.save(path, tableKeySignature());
+}
+
+bool Search::loadTable(const std::string &path)
+{
+	stopSearch();
+	waitForSearch();
+
+	return _transpositionTable.load(path, tableKeySignature());
+}
+
+bool Search::setSharedTable(const std::string &name, const usize sizeMb)
+{
+	stopSearch();
+	waitForSearch();
+
+	return _transpositionTable.setShared(name, sizeMb, tableKeySignature());
+}
+
+u64 Search::tableKeySignature()
+{
+	Board board;
+	board.setToStartPos();
+	return board.zKey();
 }
 
 bool Search::setTableSize(const usize sizeMb)
 {
-	return _transpositionTable.setSize(sizeMb);
+	if (!_transpositionTable.setSize(sizeMb))
+		return false;
+
+	const auto pageSize = _transpositionTable.pageSize();
+	std::cout << "info string Hash table of " << _transpositionTable.sizeMb() << "MB";
+
+	switch (_transpositionTable.pageType())
+	{
+		case TranspositionTable::PageType::HUGE:
+			std::cout << " uses " << (pageSize >> 20u) << "MB huge pages";
+			break;
+		case TranspositionTable::PageType::TRANSPARENT_HUGE:
+			std::cout << " requested transparent " << (pageSize >> 20u) << "MB huge pages";
+			break;
+		case TranspositionTable::PageType::NORMAL:
+			if (pageSize != 0)
+				std::cout << " uses " << (pageSize >> 10u) << "KB pages";
+			break;
+	}
+
+	std::cout << std::endl;
+	return true;
 }
 
-Move Search::findBestMove(Board board, const SearchOptions &searchOptions)
+void Search::setThreadCount(const usize threadCount)
 {
+	stopSearch();
+	waitForSearch();
+	_threadPool.resize(threadCount);
+}
+
+void Search::startSearch(const Board &board, const SearchOptions &searchOptions)
+{
+	// Make sure the previous search has completely finished
+	stopSearch();
+	waitForSearch();
+
+	// The clock is already running, so start measuring the time as soon as possible
+	_timeManager.init(searchOptions);
+
 	Stats::resetStats();
 	// Apply SearchOptions
 	_searchOptions = searchOptions;
-	const auto threadCount = _searchOptions.threadCount();
 
-	_transpositionTable.update();
 	if (_searchOptions.tableSizeMb() != 0)
 		setTableSize(_searchOptions.tableSizeMb());
+	_transpositionTable.update();
+
+	_threadPool.resize(_searchOptions.threadCount());
 
-	board.ply = 0;
 	// Reset Depth Counter
 	_sharedState.reset();
 
 	Stats::restartTimer();
 
-	if (PolyBook::isEnabled() && _sharedState.useBook)
+	// A book move would have to be sent before the ponder hit, so search instead
+	if (PolyBook::isEnabled() && _sharedState.useBook && !_searchOptions.ponder())
 	{
 		const Move move = PolyBook::getBookMove(board);
 		if (!move.empty())
 		{
 			std::cout << "bestmove " << move.toString() << std::endl;
-			return move;
+			_sharedState.lastReportedBestMove = move;
+			return;
 		} else
 		{
 			// No move has been found so no other moves will be found from here on out
@@ -76,159 +180,235 @@ Move Search::findBestMove(Board board, const SearchOptions &searchOptions)
 		}
 	}
 
-	const auto work = [&, board](const i32 threadId)
+	Board rootBoard = board;
+	rootBoard.ply = 0;
+
+	const MoveList rootMoveList(rootBoard);
+
+	const auto &searchMoves = _searchOptions.searchMoves();
+	_rootMoves.clear();
+	for (const Move move : rootMoveList)
+		if (searchMoves.empty() || std::find(searchMoves.begin(), searchMoves.end(), move) != searchMoves.end())
+			_rootMoves.emplace_back(move);
+
+	if (_rootMoves.empty())
 	{
-		assert(threadId >= 1);
-		assert(threadId <= i32(threadCount));
-		localThreadInfo = new Thread(threadId, threadId == 1);
+		std::cout << "bestmove 0000" << std::endl;
+		return;
+	}
+
+	_threadPool.start([rootBoard](Thread &thread)
+	{
+		assert(thread.threadId >= 1);
+		assert(thread.threadId <= _threadPool.size());
+		localThreadInfo = &thread;
+		thread.ageTables();
+		thread.rootMoves = _rootMoves;
+		thread.nodesCount = 0;
+		thread.reportedNodes = 0;
+
+		const auto threadId = i32(thread.threadId);
 
 		while (!_sharedState.stopped)
 		{
 			const auto currentDepth = i32(_sharedState.depth);
 			const auto depth = currentDepth + 1 + i32(Bits::bitScanForward(u64(threadId)));
 
-			iterativeDeepening(board, std::min<i32>(depth, _searchOptions.depth()));
+			// Starting over would only repeat the same iterations
+			if (iterativeDeepening(rootBoard, std::min<i32>(depth, _searchOptions.depth())))
+				break;
 		}
 
-		delete localThreadInfo;
-		localThreadInfo = nullptr;
-	};
+		if (thread.mainThread)
+		{
+			// An infinite or ponder search may only send the best move once it is stopped or the ponder move is played
+			{
+				std::unique_lock lock{ _sharedState.mutex };
+				_sharedState.stopCondition.wait(lock, []
+				{
+					return _sharedState.stopped || !(_searchOptions.infinite() || _timeManager.isPondering());
+				});
+			}
 
-	std::vector<std::thread> threads;
-	threads.reserve(threadCount);
+			stopSearch();
 
-	for (usize i{}; i < threadCount; ++i)
-		threads.emplace_back(work, i32(i) + 1);
+			Board finalBoard = rootBoard;
+			printBestMove(finalBoard);
+		}
+	});
+}
 
-	for (auto &&thread : threads)
-		thread.join();
+void Search::waitForSearch()
+{
+	_threadPool.wait();
+}
+
+Move Search::findBestMove(const Board &board, const SearchOptions &searchOptions)
+{
+	startSearch(board, searchOptions);
+	waitForSearch();
 
 	const Move move = _sharedState.lastReportedBestMove;
 	assert(!move.empty());
 	return move;
 }
 
-void Search::printUci(Board &board)
+void Search::printUci()
 {
 	if (!threadInfo().mainThread)
 		return;
-	std::array<Move, MAX_DEPTH> pvArray{};
 
-	const auto getPvLine = [&board, &pvArray](const int depth) -> int
+	if (!_sharedState.stopped && _sharedState.depth > _sharedState.lastReportedDepth)
 	{
-		assert(depth <= MAX_DEPTH);
-
-		int count{};
+		int depth;
+		i64 time;
+		RootMoves rootMoves;
 
-		while (true)
 		{
-			const auto probedResult = _transpositionTable.probe(board.zKey());
+			std::lock_guard lock{ _sharedState.mutex };
+			depth = _sharedState.depth;
+			time = _sharedState.time;
+			rootMoves = _sharedState.rootMoves;
+		}
 
-			if (!probedResult.has_value() || count >= depth)
-				break;
+		const u64 nodes = _sharedState.nodes;
+		const int hashfull = _transpositionTable.hashfull();
 
-			const Move probedMove = probedResult->move();
-			const MoveList moveList(board);
+		for (usize i{}; i < rootMoves.size(); ++i)
+		{
+			const auto &rootMove = rootMoves[i];
+			const int cp = rootMove.score * 100 / 213;
 
-			for (const Move &fullMove : moveList)
-			{
-				if (fullMove.getFromToBits() == probedMove.getFromToBits())
-				{
-					if (board.isMoveLegal(fullMove))
-					{
-						board.makeMove(fullMove);
-						pvArray[count++] = fullMove;
-						break;
-					}
-				}
-			}
-		}
+			std::cout << "info depth " << depth;
+			if (rootMoves.size() > 1)
+				std::cout << " multipv " << i + 1;
+			std::cout << " score cp " << cp << " nodes " << nodes << " hashfull " << hashfull << " time " << time;
 
-		while (board.ply > 0)
-			board.undoMove();
+			std::cout << " pv";
+			for (usize j{}; j < rootMove.pvLength; ++j)
+				std::cout << ' ' << rootMove.pv[j].toString();
 
-		return count;
-	};
+			std::cout << '\n';
+		}
+		std::cout.flush();
 
-	int depth;
-	int bestScore;
-	usize time;
+		const auto &bestRootMove = rootMoves.front();
+		_sharedState.lastReportedDepth = depth;
+		_sharedState.lastReportedBestMove = bestRootMove.move;
+		_sharedState.lastReportedPonderMove = bestRootMove.pvLength > 1 ? bestRootMove.pv[1] : Move{};
 
-	{
-		std::lock_guard lock{ _sharedState.mutex };
-		depth = _sharedState.depth;
-		bestScore = _sharedState.bestScore;
-		time = _sharedState.time;
+		if (_timeManager.iterationCompleted(bestRootMove.move, bestRootMove.score))
+			stopSearch();
 	}
 
-	const int lastReportedDepth = _sharedState.lastReportedDepth;
-	if (!_sharedState.stopped && depth > lastReportedDepth)
+	// While pondering, the best move may only be sent after the ponder hit
+	if (_sharedState.lastReportedDepth >= _searchOptions.depth()
+		&& !_timeManager.isPondering() && !_searchOptions.infinite())
+		stopSearch();
+}
+
+void Search::printBestMove(Board &board)
+{
+	if (_sharedState.lastReportedBestMove.empty())
 	{
-		const int pvMoves = getPvLine(depth);
+		const MoveList moveList(board);
 
-		const int cp = bestScore * 100 / 213;
-		std::cout << "info depth " << depth << " score cp " << cp
-				  << " nodes " << _sharedState.nodes << " time " << time;
+		std::cout << "No move found, returning: " << moveList.front().toString() << '\n';
+		_sharedState.lastReportedBestMove = moveList.front();
+	}
 
-		std::cout << " pv: ";
-		for (int pvCount = 0; pvCount < pvMoves; ++pvCount)
-			std::cout << pvArray[pvCount].toString() << ' ';
+	if (Stats::isEnabled())
+		std::cout << "info string " << Stats::formatStats(' ') << '\n';
 
-		std::cout << std::endl;
+	const Move bestMove = _sharedState.lastReportedBestMove;
+	std::cout << "bestmove " << bestMove.toString();
+	if (const Move ponderMove = findPonderMove(board, bestMove); !ponderMove.empty())
+		std::cout << " ponder " << ponderMove.toString();
+	std::cout << std::endl;
+}
 
-		_sharedState.lastReportedDepth = depth;
-		_sharedState.lastReportedBestMove = pvArray[0];
+Move Search::findPonderMove(Board &board, const Move bestMove)
+{
+	if (!_sharedState.lastReportedPonderMove.empty()
+		&& _sharedState.lastReportedBestMove == bestMove)
+		return _sharedState.lastReportedPonderMove;
 
-		if (depth >= _searchOptions.depth())
-			stopSearch();
-	}
+	// The PV may end after the best move, so try to find the expected reply in the TT
+	Move ponderMove;
+	board.makeMove(bestMove);
 
-	if (_sharedState.stopped)
+	if (const auto probeResult = _transpositionTable.probe(board.zKey()); probeResult.has_value())
 	{
-		if (_sharedState.lastReportedBestMove.empty())
-		{
-			MoveList moveList(board);
-			MoveOrdering::sortQMoves(moveList);
-
-			std::cout << "No move found, returning: " << moveList.front().toString() << '\n';
-			_sharedState.lastReportedBestMove = moveList.front();
-		}
-		std::cout << "bestmove " << _sharedState.lastReportedBestMove.toString() << std::endl;
+		const Move ttMove = probeResult->move();
+		const Move move = board.getPseudoLegalMove(ttMove.from(), ttMove.to(), ttMove.promotedPiece());
+		if (!move.empty() && board.isMoveLegal(move))
+			ponderMove = move;
 	}
+
+	board.undoMove();
+	return ponderMove;
 }
 
-void Search::iterativeDeepening(Board board, const int targetDepth)
+bool Search::iterativeDeepening(Board board, const int targetDepth)
 {
 	auto &&thread = threadInfo();
+	auto &&rootMoves = thread.rootMoves;
+	const usize multiPv = std::min(_searchOptions.multiPv(), rootMoves.size());
 	int bestScore = VALUE_MIN;
 
 	for (int currentDepth = 1; currentDepth <= targetDepth; ++currentDepth)
 	{
-		// Stop if we have found a mate value
-		if (bestScore > VALUE_MATE_MAX_DEPTH /*&& !bestMove.empty()*/)
-			break;
+		for (auto &&rootMove : rootMoves)
+			rootMove.nodes = 0;
 
-		thread.nodesCount = 0;
+		for (thread.pvIndex = 0; thread.pvIndex < multiPv; ++thread.pvIndex)
+		{
+			// The aspiration window can only be used when just the best line needs an exact score
+			if (multiPv == 1)
+				aspirationWindow(board, currentDepth, bestScore);
+			else
+				search(board, VALUE_MIN, VALUE_MAX, currentDepth, true, true, true);
+
+			if (_sharedState.stopped)
+				break;
+
+			std::stable_sort(rootMoves.begin() + thread.pvIndex, rootMoves.end(),
+							 [](const RootMove &lhs, const RootMove &rhs) { return lhs.score > rhs.score; });
+		}
 
-		bestScore = aspirationWindow(board, currentDepth, bestScore);
-		_sharedState.nodes += thread.nodesCount;
+		reportNodes(thread);
 
-		if (bestScore != VALUE_MIN && currentDepth > _sharedState.depth)
+		if (!_sharedState.stopped)
 		{
-			std::lock_guard lock{ _sharedState.mutex };
+			bestScore = rootMoves.front().score;
+
+			// The moves outside of the MultiPV lines are ordered by how many nodes it took to refute them
+			std::stable_sort(rootMoves.begin() + multiPv, rootMoves.end(),
+							 [](const RootMove &lhs, const RootMove &rhs) { return lhs.nodes > rhs.nodes; });
+
 			if (currentDepth > _sharedState.depth)
 			{
-				_sharedState.depth = currentDepth;
-				_sharedState.bestScore = bestScore;
-				_sharedState.time = Stats::getElapsedMs();
+				std::lock_guard lock{ _sharedState.mutex };
+				if (currentDepth > _sharedState.depth)
+				{
+					_sharedState.depth = currentDepth;
+					_sharedState.time = Stats::getElapsedMs();
+					_sharedState.rootMoves.assign(rootMoves.begin(), rootMoves.begin() + multiPv);
+				}
 			}
 		}
 
-		printUci(board);
+		printUci();
 
 		if (_sharedState.stopped)
-			break;
+			return false;
+
+		// Every line is a forced mate, only an infinite search keeps looking for shorter ones
+		if (rootMoves[multiPv - 1].score > VALUE_MATE_MAX_DEPTH && !_searchOptions.infinite())
+			return true;
 	}
+
+	return targetDepth >= _searchOptions.depth();
 }
 
 int Search::aspirationWindow(Board &board, const int depth, const int bestScore)
@@ -279,13 +459,16 @@ int Search::search(Board &board, int alpha, int beta, const int depth, const boo
 	if (rootNode)
 		assert(isPvNode);
 
+	auto &&thread = threadInfo();
+	thread.clearPv(board.ply);
+
 	// Try to prefetch the Transposition Table as soon as possible
 	_transpositionTable.prefetch(board.zKey());
 
 	if (checkTimeAndStop())
 		return 0;
 
-	++threadInfo().nodesCount;
+	++thread.nodesCount;
 
 	if (!rootNode)
 	{
@@ -293,41 +476,43 @@ int Search::search(Board &board, int alpha, int beta, const int depth, const boo
 			return 0;
 
 		if (board.ply >= MAX_DEPTH)
-			return Evaluation::invertedValue(board);
+			return staticEval(board, std::nullopt);
 	}
 
 	if (depth <= 0)
 		return _searchOptions.quietSearch()
 			   ? searchCaptures(board, alpha, beta, depth)
-			   : Evaluation::invertedValue(board);
+			   : staticEval(board, std::nullopt);
 
 	const int originalAlpha = alpha;
 	const int startPly = board.ply;
-	auto &&thread = threadInfo();
 
 	const bool nodeInCheck = board.isSideInCheck();
 	int eval = thread.evalStack[startPly] = VALUE_NONE;
 	int improvement{};
 
+	// Probe the Transposition Table
+	const auto probeResult = _transpositionTable.probe(board.zKey());
+	const Move ttMove = probeResult.has_value() ? probeResult->move() : Move{};
+	Stats::incTtProbes(probeResult.has_value());
+
 	if (!nodeInCheck)
 	{
 		auto &&evalStack = thread.evalStack;
-		evalStack[startPly] = eval = Evaluation::invertedValue(board);
+		evalStack[startPly] = eval = staticEval(board, probeResult);
 		improvement =
 			(startPly > 2 && evalStack[startPly - 2] != VALUE_NONE) ? (eval - evalStack[startPly - 2])
 																	: (startPly > 4 &&
 																	   evalStack[startPly - 4] != VALUE_NONE)
 																	  ? (eval - evalStack[startPly - 4]) : 200;
 
-		// Probe the Transposition Table
-		const auto probeResult = _transpositionTable.probe(board.zKey());
 		// Only cut with a greater depth and if this is not a PvNode
 		if (probeResult.has_value()
 			&& !probeResult->qSearch()
 			&& probeResult->depth() >= depth
 			&& (depth == 0 || !isPvNode))
 		{
-			const auto entryValue = probeResult->move().getScore();
+			const auto entryValue = valueFromTt(probeResult->move().getScore(), startPly);
 			const auto entryBound = probeResult->bound();
 
 			if (entryBound == SearchEntry::Bound::EXACT
@@ -368,29 +553,39 @@ int Search::search(Board &board, int alpha, int beta, const int depth, const boo
 		}
 	}
 
-	MoveList moveList(board);
-	MoveOrdering::sortMoves(thread, board, moveList);
+	MovePicker movePicker(thread, board, ttMove);
+	// The root moves are searched in the order given by the previous iteration, skipping the previous MultiPV lines
+	usize rootMoveIndex = thread.pvIndex;
 
 	usize legalCount{};
 	usize searchedCount{};
 	int bestScore = Value::VALUE_MIN;
 	Move bestMove;
 
-	while (!moveList.empty())
+	while (true)
 	{
 		assert(startPly == board.ply);
 
-		const Move move = MoveOrdering::getNextMove(moveList);
-		const bool pvMove = move.flags().pvMove();
+		Move move;
+		if (rootNode)
+		{
+			if (rootMoveIndex < thread.rootMoves.size())
+				move = thread.rootMoves[rootMoveIndex++].move;
+		} else
+			move = movePicker.nextMove();
+
+		if (move.empty())
+			break;
+
+		const bool pvMove = rootNode ? rootMoveIndex == thread.pvIndex + 1 : move == movePicker.ttMove();
 
-		if (!board.isMoveLegal(move))
-			continue;
 		++legalCount;
 
 		const bool moveGivesCheck = board.doesMoveGiveCheck(move);
 
-		// Futility Pruning
-		if (depth < FUTILITY_MAX_DEPTH
+		// Futility Pruning, every root move needs a score
+		if (!rootNode
+			&& depth < FUTILITY_MAX_DEPTH
 			&& !pvMove
 			&& searchedCount > 3
 			&& futilityMarginEval <= alpha
@@ -407,6 +602,7 @@ int Search::search(Board &board, int alpha, int beta, const int depth, const boo
 			continue;
 		}
 
+		const u64 nodesBefore = thread.nodesCount;
 		board.makeMove(move, moveGivesCheck);
 
 		int moveScore = alpha;
@@ -440,6 +636,25 @@ int Search::search(Board &board, int alpha, int beta, const int depth, const boo
 		const int searchedPly = board.ply;
 		board.undoMove();
 
+		if (rootNode && !_sharedState.stopped)
+		{
+			auto &&rootMove = thread.rootMoves[rootMoveIndex - 1];
+			rootMove.nodes += thread.nodesCount - nodesBefore;
+
+			// Only the first move and the ones that raise alpha have an exact score
+			if (pvMove || moveScore > alpha)
+			{
+				const auto &childLine = thread.pvTable[1];
+				const u8 childLength = thread.pvLength[1];
+
+				rootMove.score = moveScore;
+				rootMove.pv[0] = move;
+				std::copy(childLine.begin() + 1, childLine.begin() + childLength, rootMove.pv.begin() + 1);
+				rootMove.pvLength = std::max<u8>(childLength, 1);
+			} else
+				rootMove.score = VALUE_MIN;
+		}
+
 		// Mate Pruning
 		if (moveScore == Value::VALUE_MAX - searchedPly) // Winning
 		{
@@ -467,7 +682,8 @@ int Search::search(Board &board, int alpha, int beta, const int depth, const boo
 			if (bestScore > alpha)
 			{
 				alpha = bestScore;
-				thread.history[move.from()][move.to()] += depth;
+				thread.addHistory(move.from(), move.to(), depth);
+				thread.updatePv(startPly, move);
 			}
 		}
 
@@ -492,9 +708,12 @@ int Search::search(Board &board, int alpha, int beta, const int depth, const boo
 
 	Stats::incNodesSearched(searchedCount);
 
-	// Store the results of search
-	bestMove.setScore(bestScore);
-	storeTTEntry(bestMove, board.zKey(), alpha, originalAlpha, beta, depth, false);
+	// Store the results of search, except for the root of the other MultiPV lines, as they exclude the best moves
+	if (!rootNode || thread.pvIndex == 0)
+	{
+		bestMove.setScore(bestScore);
+		storeTTEntry(bestMove, board.zKey(), alpha, originalAlpha, beta, depth, startPly, eval, false);
+	}
 
 	assert(abs(bestScore) != VALUE_MIN);
 	return alpha;
@@ -509,11 +728,12 @@ int Search::searchCaptures(Board &board, int alpha, int beta, const int depth)
 		return 0;
 
 	++threadInfo().nodesCount;
+	Stats::incQNodesSearched();
 
 	const short startPly = board.ply;
 
 	if (startPly >= MAX_DEPTH)
-		return Evaluation::invertedValue(board);
+		return staticEval(board, std::nullopt);
 
 	const bool nodeInCheck = board.isSideInCheck();
 
@@ -522,13 +742,23 @@ int Search::searchCaptures(Board &board, int alpha, int beta, const int depth)
 	int bestScore = Value::VALUE_MIN;
 	Move bestMove;
 
+	// The results of the quiescence search are only stored in the cache of this thread,
+	// an entry of the main search in the Transposition Table is always deeper, so it is preferred
+	auto probeResult = _transpositionTable.probe(board.zKey());
+	Stats::incTtProbes(probeResult.has_value());
+	if (!probeResult.has_value())
+	{
+		probeResult = threadInfo().qSearchCache.probe(board.zKey());
+		Stats::incQCacheProbes(probeResult.has_value());
+	}
+	const Move ttMove = probeResult.has_value() ? probeResult->move() : Move{};
+
 	if (!nodeInCheck)
 	{
-		const auto probeResult = _transpositionTable.probe(board.zKey());
 		if (probeResult.has_value()
 			&& probeResult->depth() >= depth)
 		{
-			const i32 entryValue = probeResult->move().getScore();
+			const i32 entryValue = valueFromTt(probeResult->move().getScore(), startPly);
 			const auto bound = probeResult->bound();
 
 			if (bound == SearchEntry::Bound::EXACT)
@@ -542,37 +772,34 @@ int Search::searchCaptures(Board &board, int alpha, int beta, const int depth)
 				return entryValue;
 		}
 
-		standPat = Evaluation::invertedValue(board);
+		bestScore = standPat = staticEval(board, probeResult);
 
 		alpha = std::max(alpha, standPat);
 		if (alpha >= beta)
 			return standPat;
 	}
 
-	MoveList moveList(board);
-
-	MoveOrdering::sortQMoves(moveList);
+	// Only captures, promotions and at the first ply quiet checks are returned,
+	// unless we have to look for all the check evasions
+	MovePicker movePicker(threadInfo(), board, ttMove, depth);
 	usize legalCount{};
 	usize searchedCount{};
 
 	const bool isEndGame = board.getPhase() < Phase::MIDDLE_GAME_PHASE / 3;
 
-	while (!moveList.empty())
+	while (true)
 	{
 		assert(startPly == board.ply);
 
-		const Move move = MoveOrdering::getNextMove(moveList);
+		const Move move = movePicker.nextMove();
+		if (move.empty())
+			break;
 
-		if (!board.isMoveLegal(move))
-			continue;
 		++legalCount;
 
-		if (!nodeInCheck // Look for all check evasions
-			&& !move.isTactical()
-			&& searchedCount)
-		{
-			break; // The moves are sorted so we can break if is not a capture
-		}
+		// Skip the captures that lose material
+		if (!nodeInCheck && !board.see(move))
+			continue;
 
 		const int futilityEval = standPat + PSQT[move.piece()][move.to()].eg
 								 + Evaluation::getPieceValue(move.promotedPiece())
@@ -611,13 +838,13 @@ int Search::searchCaptures(Board &board, int alpha, int beta, const int depth)
 		alpha = std::max(alpha, moveScore);
 	}
 
-	if (legalCount == 0)
-		return board.isSideInCheck() ? Value::VALUE_MIN + board.ply : 0;
+	if (nodeInCheck && legalCount == 0)
+		return Value::VALUE_MIN + board.ply;
 
-	if (!nodeInCheck)
+	if (!nodeInCheck && !bestMove.empty())
 	{
 		bestMove.setScore(bestScore);
-		storeTTEntry(bestMove, board.zKey(), alpha, originalAlpha, beta, depth, true);
+		storeTTEntry(bestMove, board.zKey(), alpha, originalAlpha, beta, depth, startPly, standPat, true);
 	}
 
 	Stats::incNodesSearched(searchedCount);
@@ -627,7 +854,7 @@ int Search::searchCaptures(Board &board, int alpha, int beta, const int depth)
 
 inline void Search::storeTTEntry(const Move &bestMove, const u64 key, const int alpha,
 								 const int originalAlpha, const int beta, const int depth,
-								 const bool qSearch)
+								 const int ply, const int eval, const bool qSearch)
 {
 	// Avoid putting an empty move in the Transposition Table if alpha was not raised
 	assert(!bestMove.empty());
@@ -639,16 +866,73 @@ inline void Search::storeTTEntry(const Move &bestMove, const u64 key, const int
 	else if (bestMove.getScore() >= beta)
 		bound = SearchEntry::Bound::BETA;
 
-	_transpositionTable.insert(key, SearchEntry{ key, i8(depth), bestMove, qSearch, bound });
+	Move entryMove = bestMove;
+	entryMove.setScore(valueToTt(bestMove.getScore(), ply));
+
+	const SearchEntry entry{ i8(depth), entryMove, qSearch, bound, eval };
+	if (qSearch)
+		threadInfo().qSearchCache.insert(key, entry);
+	else
+		_transpositionTable.insert(key, entry);
+}
+
+int Search::staticEval(const Board &board, const std::optional<SearchEntry> &entry) noexcept
+{
+	if (entry.has_value() && entry->eval() != VALUE_NONE)
+	{
+		Stats::incTtEvals();
+		return entry->eval();
+	}
+
+	auto &&evalCache = threadInfo().evalCache;
+	if (const auto cachedEval = evalCache.probe(board.zKey()); cachedEval.has_value())
+	{
+		Stats::incEvalCacheHits();
+		return *cachedEval;
+	}
+
+	const int eval = Evaluation::invertedValue(board);
+	evalCache.insert(board.zKey(), eval);
+	return eval;
+}
+
+int Search::valueToTt(const int value, const int ply) noexcept
+{
+	if (value >= VALUE_MATE_MAX_DEPTH)
+		return value + ply;
+	if (value <= -VALUE_MATE_MAX_DEPTH)
+		return value - ply;
+	return value;
+}
+
+int Search::valueFromTt(const int value, const int ply) noexcept
+{
+	if (value >= VALUE_MATE_MAX_DEPTH)
+		return value - ply;
+	if (value <= -VALUE_MATE_MAX_DEPTH)
+		return value + ply;
+	return value;
+}
+
+u64 Search::reportNodes(Thread &thread)
+{
+	const u64 nodes = _sharedState.nodes += thread.nodesCount - thread.reportedNodes;
+	thread.reportedNodes = thread.nodesCount;
+	return nodes;
 }
 
 bool Search::checkTimeAndStop()
 {
-	if (threadInfo().mainThread
-		&& _searchOptions.isTimeSet()
-		&& (threadInfo().nodesCount & 2047u) == 0
-		&& Stats::getElapsedMs() >= _searchOptions.searchTime())
-		stopSearch();
+	auto &&thread = threadInfo();
+
+	if (thread.nodesCount - thread.reportedNodes >= NODES_CHECK_INTERVAL)
+	{
+		const u64 nodes = reportNodes(thread);
+
+		if ((_searchOptions.isNodesLimitSet() && nodes >= _searchOptions.nodesLimit())
+			|| (thread.mainThread && _timeManager.isMaximumReached()))
+			stopSearch();
+	}
 
 	return _sharedState.stopped;
 }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <condition_variable>
+
 #include "../SearchOptions.h"
 #include "../Move.h"
 #include "../TranspositionTable.h"
+#include "../ThreadPool.h"
+#include "TimeManager.h"
 
 class Board;
 
@@ -11,18 +15,24 @@ class Search final
 private:
 	struct SharedState
 	{
-		bool stopped{};
+		std::atomic_bool stopped{};
 		std::atomic_uint64_t nodes{};
 
 		mutable std::mutex mutex{};
+		/**
+		 * Notified when the search is stopped or the ponder move is played
+		 */
+		std::condition_variable stopCondition{};
 		// Stats for the last time the depth was updated
 		std::atomic_int depth{};
-		int bestScore{};
 		i64 time{};
+		// The best root moves, one for each MultiPV line
+		RootMoves rootMoves{};
 
 		// This should only be read and written by the main thread
 		int lastReportedDepth{};
 		Move lastReportedBestMove{};
+		Move lastReportedPonderMove{};
 		bool useBook{};
 
 		void reset() noexcept
@@ -30,9 +40,11 @@ private:
 			stopped = false;
 			nodes = 0;
 			depth = 0;
-			bestScore = VALUE_MIN;
 			time = 0;
+			rootMoves.clear();
 			lastReportedDepth = 0;
+			lastReportedBestMove = {};
+			lastReportedPonderMove = {};
 		}
 
 		void fullReset() noexcept
@@ -45,6 +57,9 @@ private:
 	static SearchOptions _searchOptions;
 	static TranspositionTable _transpositionTable;
 	static SharedState _sharedState;
+	static ThreadPool _threadPool;
+	static TimeManager _timeManager;
+	static RootMoves _rootMoves;
 
 public:
 	Search() = delete;
@@ -56,21 +71,72 @@ public:
 
 	static void clearAll();
 	static void stopSearch();
+	/**
+	 * Turns the current ponder search into a normal search, keeping everything searched so far
+	 */
+	static void ponderHit();
 	static bool setTableSize(usize sizeMb);
+	static void setThreadCount(usize threadCount);
+
+	/**
+	 * Stop the current search, then save the Transposition Table to a file or replace it with a saved one
+	 */
+	static bool saveTable(const std::string &path);
+	static bool loadTable(const std::string &path);
+	/**
+	 * Stop the current search, then map the Transposition Table from a shared memory segment,
+	 * or go back to a private table of sizeMb if the name is empty
+	 */
+	static bool setSharedTable(const std::string &name, usize sizeMb);
 
-	static Move findBestMove(Board board, const SearchOptions &searchOptions);
+	/**
+	 * Starts the search on the thread pool and returns immediately,
+	 * the best move is printed by the main thread once the search is done
+	 */
+	static void startSearch(const Board &board, const SearchOptions &searchOptions);
+	static void waitForSearch();
+	static Move findBestMove(const Board &board, const SearchOptions &searchOptions);
 
 	static auto &getTranspTable() noexcept { return _transpositionTable; }
 
+	/**
+	 * Nodes searched by all threads during the last search
+	 */
+	static u64 getNodesCount() noexcept { return _sharedState.nodes; }
+
 private:
-	static void printUci(Board &board);
-	static void iterativeDeepening(Board board, int targetDepth);
+	static void printUci();
+	static void printBestMove(Board &board);
+	static Move findPonderMove(Board &board, Move bestMove);
+	/**
+	 * @return true if there is nothing left to search, the maximum depth was reached or a mate was found
+	 */
+	static bool iterativeDeepening(Board board, int targetDepth);
 	static int aspirationWindow(Board &board, int depth, int bestScore);
 	static int search(Board &board, int alpha, int beta, int depth, bool isPvNode,
 					  bool doNull, bool doLmr);
 	static int searchCaptures(Board &board, int alpha, int beta, int depth);
 
 	inline static void storeTTEntry(const Move &bestMove, u64 key, int alpha, int originalAlpha,
-									int beta, int depth, bool qSearch);
+									int beta, int depth, int ply, int eval, bool qSearch);
+
+	/**
+	 * Static evaluation for the side to move, taken from the entry of the position if it has one,
+	 * or else from the evaluation cache of the thread
+	 */
+	static int staticEval(const Board &board, const std::optional<SearchEntry> &entry) noexcept;
+
+	/**
+	 * Mate scores are relative to the root, but are stored in the Transposition Table relative to the
+	 * position they belong to, so that they stay correct when it is reached from another ply or search
+	 */
+	static int valueToTt(int value, int ply) noexcept;
+	static int valueFromTt(int value, int ply) noexcept;
+
+	/**
+	 * Identifies the Zobrist keys of this build, the keys stored in a saved table must have been made with them
+	 */
+	static u64 tableKeySignature();
+	static u64 reportNodes(Thread &thread);
 	static bool checkTimeAndStop();
 };
@@ -0,0 +1,103 @@
+#include "TimeManager.h"
+
+#include <algorithm>
+
+#include "../SearchOptions.h"
+
+namespace
+{
+	constexpr i64 DEFAULT_MOVES_TO_GO = 35;
+	constexpr i64 MAX_MOVES_TO_GO = 50;
+	// The maximum time is a multiple of the optimum time, but never more than this percentage of the clock
+	constexpr i64 MAXIMUM_TIME_RATIO = 4;
+	constexpr i64 MAXIMUM_CLOCK_PERCENT = 80;
+
+	// The next iteration is expected to take at least this many times longer than the last one
+	constexpr i64 NEXT_ITERATION_FACTOR = 2;
+
+	constexpr int STABLE_ITERATIONS = 4;
+	constexpr double STABLE_SCALE = 0.6;
+	constexpr double BEST_MOVE_CHANGE_SCALE = 0.6;
+	constexpr int MAX_SCORE_DROP = 200;
+	constexpr double SCORE_DROP_SCALE = 0.5 / MAX_SCORE_DROP;
+}
+
+void TimeManager::init(const SearchOptions &options) noexcept
+{
+	_startTime = now();
+	_pondering = options.ponder();
+	_optimum = 0;
+	_maximum = 0;
+	_lastIterationEnd = 0;
+	_lastBestMove = {};
+	_lastScore = VALUE_NONE;
+	_stableIterations = 0;
+	_bestMoveChanges = 0;
+
+	const i64 overhead = options.moveOverhead();
+
+	if (options.searchTime() != 0)
+	{
+		// A fixed time per move can not be adjusted
+		_optimum = _maximum = std::max<i64>(1, options.searchTime() - overhead);
+		return;
+	}
+
+	if (options.timeLeft() == 0)
+		return;
+
+	const i64 time = options.timeLeft();
+	const i64 movesToGo = options.movesToGo() != 0
+						  ? std::min<i64>(options.movesToGo(), MAX_MOVES_TO_GO)
+						  : DEFAULT_MOVES_TO_GO;
+
+	// The time available for all the remaining moves, keeping the overhead aside for each of them
+	const i64 totalTime = std::max<i64>(
+		1, time + options.increment() * (movesToGo - 1) - overhead * (movesToGo + 2));
+	const i64 clockLimit = std::max<i64>(1, (time - overhead) * MAXIMUM_CLOCK_PERCENT / 100);
+
+	_maximum = std::min(totalTime / movesToGo * MAXIMUM_TIME_RATIO, clockLimit);
+	_optimum = std::min(totalTime / movesToGo, _maximum);
+	_maximum = std::max<i64>(1, _maximum);
+	_optimum = std::max<i64>(1, _optimum);
+}
+
+bool TimeManager::iterationCompleted(const Move bestMove, const int score) noexcept
+{
+	if (!isTimeSet())
+		return false;
+
+	// The elapsed time restarts on a ponder hit
+	const i64 elapsedTime = elapsed();
+	const i64 iterationTime = std::max<i64>(0, elapsedTime - _lastIterationEnd);
+	_lastIterationEnd = elapsedTime;
+
+	// Old best move changes matter less and less
+	_bestMoveChanges /= 2;
+	if (!_lastBestMove.empty() && bestMove != _lastBestMove)
+	{
+		_bestMoveChanges += 1;
+		_stableIterations = 0;
+	} else
+		++_stableIterations;
+
+	double scale = 1.0 + _bestMoveChanges * BEST_MOVE_CHANGE_SCALE;
+
+	// Spend more time trying to find a way out if the score dropped
+	if (_lastScore != VALUE_NONE && score < _lastScore)
+		scale *= 1.0 + std::min(_lastScore - score, MAX_SCORE_DROP) * SCORE_DROP_SCALE;
+
+	if (_stableIterations >= STABLE_ITERATIONS)
+		scale *= STABLE_SCALE;
+
+	_lastBestMove = bestMove;
+	_lastScore = score;
+
+	if (_pondering)
+		return false;
+
+	const i64 optimum = std::min<i64>(_maximum, i64(double(_optimum) * scale));
+
+	// Starting an iteration that will be stopped before it finishes only wastes time
+	return elapsedTime >= optimum || elapsedTime + iterationTime * NEXT_ITERATION_FACTOR >= _maximum;
+}
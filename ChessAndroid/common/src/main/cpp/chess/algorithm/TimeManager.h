@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "../Defs.h"
+#include "../Move.h"
+
+class SearchOptions;
+
+/**
+ * Decides how long the search of a move may last, based on the clock of the side to move.
+ * The optimum time is where the search should usually stop, it is adjusted after every iteration
+ * depending on how stable the best move and the score are, and is never allowed to exceed the maximum time,
+ * at which point the search is stopped even in the middle of an iteration.
+ * While pondering no limits apply, the clock only starts once the ponder move has been played
+ */
+class TimeManager final
+{
+public:
+	void init(const SearchOptions &options) noexcept;
+
+	[[nodiscard]] bool isTimeSet() const noexcept { return _maximum != 0; }
+
+	[[nodiscard]] i64 optimum() const noexcept { return _optimum; }
+
+	[[nodiscard]] i64 maximum() const noexcept { return _maximum; }
+
+	[[nodiscard]] i64 elapsed() const noexcept { return now() - _startTime; }
+
+	[[nodiscard]] bool isMaximumReached() const noexcept
+	{
+		return isTimeSet() && !_pondering && elapsed() >= _maximum;
+	}
+
+	[[nodiscard]] bool isPondering() const noexcept { return _pondering; }
+
+	/**
+	 * The opponent played the expected move, can be called from any thread
+	 */
+	void ponderHit() noexcept
+	{
+		_startTime = now();
+		_pondering = false;
+	}
+
+	/**
+	 * Should be called by the main thread each time a deeper iteration has been completed
+	 * @return true if the search should not start another iteration
+	 */
+	[[nodiscard]] bool iterationCompleted(Move bestMove, int score) noexcept;
+
+private:
+	static i64 now() noexcept
+	{
+		using namespace std::chrono;
+		return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	std::atomic<i64> _startTime{};
+	std::atomic_bool _pondering{};
+	i64 _optimum{};
+	i64 _maximum{};
+
+	i64 _lastIterationEnd{};
+	Move _lastBestMove{};
+	int _lastScore{};
+	int _stableIterations{};
+	double _bestMoveChanges{};
+};
@@ -1,8 +1,21 @@
+#include <cstdlib>
+#include <string_view>
+
 #include "../../ChessAndroid/common/src/main/cpp/chess/Uci.h"
+#include "../../ChessAndroid/common/src/main/cpp/chess/Tests.h"
 
-int main()
+int main(int argc, char *argv[])
 {
     Uci::init();
+
+    // "chess bench [depth] [hash]" runs the benchmark and exits
+    if (argc > 1 && std::string_view{ argv[1] } == "bench")
+    {
+        Tests::runBenchmark(argc > 2 ? std::atoi(argv[2]) : 0,
+                            argc > 3 ? usize(std::atoll(argv[3])) : 0u);
+        return 0;
+    }
+
     Uci::loop();
     return 0;
 }